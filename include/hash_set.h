@@ -36,6 +36,11 @@
 #include <immintrin.h>
 #include <vector>
 #include <cstddef>
+#include <thread>
+#include <exception>
+#include <optional>
+#include <string_view>
+#include <atomic>
 
 #if defined(_MSC_VER)
 #  if defined(__clang__)
@@ -59,10 +64,55 @@
 #  define HRD_ATTR_NORETURN __attribute__((noreturn))
 #endif
 
+//keep 7 bits of element hash in the used mark, rejects most of unequal keys without keys comparison
+#ifndef HRD_MARK_FINGERPRINT
+#  define HRD_MARK_FINGERPRINT 1
+#endif
+
+//slots of the old storage moved per modifying call of hash_incremental_set/hash_incremental_map during resize
+#ifndef HRD_REHASH_STEP
+#  define HRD_REHASH_STEP 32
+#endif
+
+//erase shifts following elements of the cluster back instead of leaving DELETED_MARK (hash_set, hash_map)
+#ifndef HRD_BACKWARD_SHIFT_ERASE
+#  define HRD_BACKWARD_SHIFT_ERASE 1
+#endif
+
+//threads of resize rehash and of random access range constructors (0 - hardware concurrency), used for
+//HRD_PARALLEL_REHASH_MIN elements and more. Hash and key-equal functors must be thread-safe then
+#ifndef HRD_REHASH_THREADS
+#  define HRD_REHASH_THREADS 1
+#endif
+
+#ifndef HRD_PARALLEL_REHASH_MIN
+#  define HRD_PARALLEL_REHASH_MIN (1 << 20)
+#endif
+
+//1 - legacy FNV based hash_1<N> and hash_<std::string> (32-bit results for keys longer than 8 bytes)
+#ifndef HRD_FNV_HASH
+#  define HRD_FNV_HASH 0
+#endif
+
 namespace hrd {
 
 #pragma region hash_base
 
+/**
+ * Default storage policy of hash_set/hash_grow_set/hash_map/hash_grow_map. Custom policy (arena, huge pages, shared memory) has the same
+ * members: allocate(bytes) returns block aligned as malloc does or nullptr (or throws), deallocate(ptr, bytes) gets the size passed to allocate.
+ * Policy object is kept in table (empty one takes no space), copied/moved/swapped with it, copies must free blocks of each other.
+ */
+struct malloc_allocator
+{
+    void* allocate(size_t bytes) noexcept {
+        return malloc(bytes);
+    }
+    void deallocate(void* p, size_t) noexcept {
+        free(p);
+    }
+};
+
 class hash_base
 {
 public:
@@ -98,6 +148,27 @@ public:
         //stub
     }
 
+    template<typename T, typename = void>
+    struct is_transparent : std::false_type {};
+
+    template<typename T>
+    struct is_transparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+    struct lookup_any_ {
+        template<class K, class Key>
+        using type = K;
+    };
+
+    struct lookup_exact_ {
+        template<class K, class Key>
+        using type = Key;
+    };
+
+    //type<K, Key> is K if both Hasher and KeyEql declare is_transparent (std::string table searched by std::string_view or const char* without temporary key), Key otherwise.
+    //Alias of alias keeps K deducible in find(const key_arg<K>&)
+    template<class Hasher, class KeyEql>
+    using lookup_key = std::conditional_t<is_transparent<Hasher>::value && is_transparent<KeyEql>::value, lookup_any_, lookup_exact_>;
+
     template <class Hasher, class KeyEql>
     class
 #if defined(_MSC_VER) && _MSC_VER >= 1915
@@ -157,18 +228,325 @@ public:
 		return hash32 ^ (hash32 >> 16);
 	}
 
+	constexpr static const uint64_t HASH_SEED = 0xa0761d6478bd642full;
+	constexpr static const uint64_t HASH_PRIME = 0xe7037ed1a0b428dbull;
+
+	/**
+	 * 64-bit hash of byte range, wyhash-style: 16 bytes per folded 128-bit multiply,
+	 * tail and short ranges (<= 16 bytes) read by overlapped loads without byte loop.
+	 * Ranges from HASH_LONG_MIN bytes go to hash_long_ (independent SIMD lanes)
+	 */
+	static HRD_ALWAYS_INLINE uint64_t hash_bytes(const void* ptr, size_t len, uint64_t seed = HASH_SEED) noexcept
+	{
+		auto* p = static_cast<const uint8_t*>(ptr);
+		uint64_t a, b;
+
+		if (HRD_LIKELY(len <= 16)) {
+			if (len >= 4) {
+				const size_t shift = (len >> 3) << 2;
+				a = (read_u32(p) << 32) | read_u32(p + shift);
+				b = (read_u32(p + len - 4) << 32) | read_u32(p + len - 4 - shift);
+			}
+			else if (len) {
+				a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+				b = 0;
+			}
+			else
+				a = b = 0;
+		}
+		else {
+			if (HRD_UNLIKELY(len >= HASH_LONG_MIN))
+				return hash_long_(p, len, seed);
+
+			for (; len > 16; len -= 16, p += 16)
+				seed = umul128(read_u64(p) ^ HASH_PRIME, read_u64(p + 8) ^ seed);
+			a = read_u64(p + len - 16);
+			b = read_u64(p + len - 8);
+		}
+		return umul128(HASH_PRIME ^ len, umul128(a ^ HASH_PRIME, b ^ seed));
+	}
+
+	//folded 128-bit product: high half xor-ed into low one, all input bits affect low bits of result
+#ifdef _MSC_VER
+    HRD_ALWAYS_INLINE static uint64_t umul128(uint64_t a, uint64_t b) noexcept {
+        uint64_t h, l = _umul128(a, b, &h);
+        return l ^ h;
+    }
+#else
+    HRD_ALWAYS_INLINE static uint64_t umul128(uint64_t a, uint64_t b) noexcept {
+        using uint128_t = unsigned __int128;
+
+        auto result = static_cast<uint128_t>(a) * static_cast<uint128_t>(b);
+        return static_cast<uint64_t>(result) ^ static_cast<uint64_t>(result >> 64U);
+    }
+#endif
+
 protected:
+    template<class table_type> friend class incremental_base;
+    template<class table_type> friend class hash_mapped;
+    template<class table_type> friend struct hash_stream;
+    template<class Table, class F> friend void parallel_for_each(const Table&, size_t, F);
+    template<class Table, class T, class Map, class Reduce> friend T parallel_reduce(const Table&, size_t, T, Map, Reduce);
+
+    HRD_ALWAYS_INLINE static uint64_t read_u64(const void* p) noexcept {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    HRD_ALWAYS_INLINE static uint64_t read_u32(const void* p) noexcept {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    constexpr static const size_t HASH_LANES = 8;
+    constexpr static const size_t HASH_STRIPE = HASH_LANES * sizeof(uint64_t);
+    constexpr static const size_t HASH_BLOCK_STRIPES = 16; //accumulators scrambled once per block
+    constexpr static const size_t HASH_LONG_MIN = 2 * HASH_STRIPE;
+    constexpr static const uint32_t HASH_PRIME32 = 0x9e3779b1;
+
+    //stripe n of a block uses HASH_SECRET[n ... n + HASH_LANES), scramble the last HASH_LANES values
+    constexpr static const uint64_t HASH_SECRET[HASH_BLOCK_STRIPES + HASH_LANES] = {
+        0x0bd2db2e48789d20ull, 0x7c621bc543b550a8ull, 0xb27410639e13de46ull, 0xd3c4eb1714b569e5ull,
+        0x9fc8be2266edda39ull, 0x491e4aceebe4be30ull, 0x180afb1a9570beb0ull, 0xca454537878d2950ull,
+        0xa96a98c828045478ull, 0xa4a4b920c8e15bf5ull, 0xae09d92fba683111ull, 0x1defe04876a32064ull,
+        0x1b830cede5f3a95full, 0x5d45a31f3dd3297full, 0x1b37fd03b9ada18eull, 0xa9cad3754033f149ull,
+        0x2bbe59b3c2df09d1ull, 0xc01f604b97fba984ull, 0xdad0325410c910f5ull, 0x0677e5dd8bdbadf9ull,
+        0x2bc9abfd44bc3b36ull, 0x08cf102312742cefull, 0x495cf4650c95833dull, 0x288961efe041bc37ull
+    };
+
+    /**
+     * HASH_LANES independent 64-bit accumulators (XXH3-style): acc[i] += lo32(k) * hi32(k) + data[i ^ 1], k = data[i] ^ secret[i].
+     * Secret slides by one lane per stripe, so equal data at different offsets of a block contributes differently.
+     * Only 32x32->64 multiplies, so SIMD and scalar versions produce identical results
+     */
+    struct hash_stripe
+    {
+#if defined(__AVX2__)
+        HRD_ALWAYS_INLINE explicit hash_stripe(uint64_t seed) noexcept {
+            const __m256i s = _mm256_set1_epi64x((long long)seed);
+            for (size_t i = 0; i < 2; ++i)
+                _v[i] = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)HASH_SECRET + i), s);
+        }
+
+        HRD_ALWAYS_INLINE void accumulate(const uint8_t* p, const uint64_t* secret) noexcept {
+            for (size_t i = 0; i < 2; ++i) {
+                __m256i d = _mm256_loadu_si256((const __m256i*)p + i);
+                __m256i k = _mm256_xor_si256(d, _mm256_loadu_si256((const __m256i*)secret + i));
+                __m256i m = _mm256_mul_epu32(k, _mm256_shuffle_epi32(k, _MM_SHUFFLE(0, 3, 0, 1)));
+                _v[i] = _mm256_add_epi64(_v[i], _mm256_add_epi64(m, _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2))));
+            }
+        }
+
+        HRD_ALWAYS_INLINE void scramble() noexcept {
+            const __m256i prime = _mm256_set1_epi32((int)HASH_PRIME32);
+            for (size_t i = 0; i < 2; ++i) {
+                __m256i a = _mm256_xor_si256(_mm256_xor_si256(_v[i], _mm256_srli_epi64(_v[i], 47)), _mm256_loadu_si256((const __m256i*)(HASH_SECRET + HASH_BLOCK_STRIPES) + i));
+                __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+                _v[i] = _mm256_add_epi64(_mm256_mul_epu32(a, prime), _mm256_slli_epi64(hi, 32));
+            }
+        }
+
+        HRD_ALWAYS_INLINE void store(uint64_t* acc) const noexcept {
+            for (size_t i = 0; i < 2; ++i)
+                _mm256_storeu_si256((__m256i*)acc + i, _v[i]);
+        }
+
+        __m256i _v[2];
+#elif !defined(HRD_HASH_SCALAR)
+        HRD_ALWAYS_INLINE explicit hash_stripe(uint64_t seed) noexcept {
+            const __m128i s = _mm_set1_epi64x((long long)seed);
+            for (size_t i = 0; i < 4; ++i)
+                _v[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)HASH_SECRET + i), s);
+        }
+
+        HRD_ALWAYS_INLINE void accumulate(const uint8_t* p, const uint64_t* secret) noexcept {
+            for (size_t i = 0; i < 4; ++i) {
+                __m128i d = _mm_loadu_si128((const __m128i*)p + i);
+                __m128i k = _mm_xor_si128(d, _mm_loadu_si128((const __m128i*)secret + i));
+                __m128i m = _mm_mul_epu32(k, _mm_shuffle_epi32(k, _MM_SHUFFLE(0, 3, 0, 1)));
+                _v[i] = _mm_add_epi64(_v[i], _mm_add_epi64(m, _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2))));
+            }
+        }
+
+        HRD_ALWAYS_INLINE void scramble() noexcept {
+            const __m128i prime = _mm_set1_epi32((int)HASH_PRIME32);
+            for (size_t i = 0; i < 4; ++i) {
+                __m128i a = _mm_xor_si128(_mm_xor_si128(_v[i], _mm_srli_epi64(_v[i], 47)), _mm_loadu_si128((const __m128i*)(HASH_SECRET + HASH_BLOCK_STRIPES) + i));
+                __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), prime);
+                _v[i] = _mm_add_epi64(_mm_mul_epu32(a, prime), _mm_slli_epi64(hi, 32));
+            }
+        }
+
+        HRD_ALWAYS_INLINE void store(uint64_t* acc) const noexcept {
+            for (size_t i = 0; i < 4; ++i)
+                _mm_storeu_si128((__m128i*)acc + i, _v[i]);
+        }
+
+        __m128i _v[4];
+#else
+        HRD_ALWAYS_INLINE explicit hash_stripe(uint64_t seed) noexcept {
+            for (size_t i = 0; i < HASH_LANES; ++i)
+                _v[i] = HASH_SECRET[i] ^ seed;
+        }
+
+        HRD_ALWAYS_INLINE void accumulate(const uint8_t* p, const uint64_t* secret) noexcept {
+            for (size_t i = 0; i < HASH_LANES; ++i) {
+                uint64_t k = read_u64(p + 8 * i) ^ secret[i];
+                _v[i] += (k & 0xffffffff) * (k >> 32) + read_u64(p + 8 * (i ^ 1));
+            }
+        }
+
+        HRD_ALWAYS_INLINE void scramble() noexcept {
+            for (size_t i = 0; i < HASH_LANES; ++i)
+                _v[i] = (_v[i] ^ (_v[i] >> 47) ^ HASH_SECRET[HASH_BLOCK_STRIPES + i]) * HASH_PRIME32;
+        }
+
+        HRD_ALWAYS_INLINE void store(uint64_t* acc) const noexcept {
+            memcpy(acc, _v, sizeof(_v));
+        }
+
+        uint64_t _v[HASH_LANES];
+#endif
+    };
+
+    static HRD_ATTR_NOINLINE uint64_t hash_long_(const uint8_t* p, size_t len, uint64_t seed) noexcept
+    {
+        hash_stripe lanes(seed);
+
+        //last stripe (full or not) handled after the loop by an overlapped load of the final HASH_STRIPE bytes
+        const uint8_t* last = p + len - HASH_STRIPE;
+        for (size_t n = 0; p < last; p += HASH_STRIPE) {
+            lanes.accumulate(p, HASH_SECRET + n);
+            if (++n == HASH_BLOCK_STRIPES) {
+                lanes.scramble();
+                n = 0;
+            }
+        }
+        lanes.accumulate(last, HASH_SECRET + HASH_BLOCK_STRIPES - 1);
+
+        uint64_t acc[HASH_LANES];
+        lanes.store(acc);
+
+        uint64_t h = len * HASH_PRIME;
+        for (size_t i = 0; i < HASH_LANES; i += 2)
+            h += umul128(acc[i] ^ HASH_SEED, acc[i + 1] ^ HASH_PRIME);
+
+        h = (h ^ (h >> 37)) * 0x165667919e3779f9ull;
+        return h ^ (h >> 32);
+    }
+
 	// Replace enum with constexpr std::byte
 	static constexpr std::byte EMPTY_MARK   = std::byte{ 0x0 };
-	static constexpr std::byte USED_MARK    = std::byte{ 0x1 };
+	static constexpr std::byte USED_MARK    = std::byte{ 0x80 }; //high bit of any used mark, low 7 bits are hash fingerprint
 	static constexpr std::byte DELETED_MARK = std::byte{ 0x2 };
 
-    /** 
+    //used mark of element with hash h
+    HRD_ALWAYS_INLINE constexpr static std::byte make_mark(size_t h) noexcept {
+#if HRD_MARK_FINGERPRINT
+        //top bits of low 32 mixed with high 32, index bits are the lowest ones
+        return USED_MARK | std::byte((uint8_t)(((uint32_t)h ^ (uint32_t)((uint64_t)h >> 32)) >> 25));
+#else
+        return USED_MARK;
+#endif
+    }
+
+    HRD_ALWAYS_INLINE constexpr static bool is_used(std::byte mark) noexcept {
+        return (mark & USED_MARK) != EMPTY_MARK;
+    }
+
+    //group of marks checked by one SIMD compare during probing
+    struct mark_group
+    {
+        using mask_type = uint32_t;
+
+#ifdef __AVX2__
+        static constexpr size_t WIDTH = 32;
+
+        HRD_ALWAYS_INLINE explicit mark_group(const std::byte* p) noexcept : _v(_mm256_loadu_si256((const __m256i*)p)) {}
+
+        HRD_ALWAYS_INLINE mask_type match(std::byte mark) const noexcept {
+            return (mask_type)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_v, _mm256_set1_epi8((char)mark)));
+        }
+
+        //used marks are the only ones with high bit set
+        HRD_ALWAYS_INLINE mask_type used() const noexcept {
+            return (mask_type)_mm256_movemask_epi8(_v);
+        }
+
+        HRD_ALWAYS_INLINE mask_type unused() const noexcept {
+            return ~used();
+        }
+
+        __m256i _v;
+#else
+        static constexpr size_t WIDTH = 16;
+
+        HRD_ALWAYS_INLINE explicit mark_group(const std::byte* p) noexcept : _v(_mm_loadu_si128((const __m128i*)p)) {}
+
+        HRD_ALWAYS_INLINE mask_type match(std::byte mark) const noexcept {
+            return (mask_type)_mm_movemask_epi8(_mm_cmpeq_epi8(_v, _mm_set1_epi8((char)mark)));
+        }
+
+        HRD_ALWAYS_INLINE mask_type used() const noexcept {
+            return (mask_type)_mm_movemask_epi8(_v);
+        }
+
+        HRD_ALWAYS_INLINE mask_type unused() const noexcept {
+            return used() ^ 0xFFFF;
+        }
+
+        __m128i _v;
+#endif
+        //valid slots of a group, less than WIDTH for tiny tables
+        HRD_ALWAYS_INLINE static mask_type lanes(size_t capacity) noexcept {
+            return (capacity + 1 >= WIDTH) ? ~mask_type(0) : ((mask_type(1) << (capacity + 1)) - 1);
+        }
+
+        //groups are WIDTH-aligned, skip slots of the first group located before probe start
+        HRD_ALWAYS_INLINE static mask_type from(size_t pos) noexcept {
+            return ~mask_type(0) << (pos & (WIDTH - 1));
+        }
+
+        HRD_ALWAYS_INLINE static size_t base(size_t pos) noexcept {
+            return pos & ~(WIDTH - 1);
+        }
+
+        //slots before the first bit of "stop" only
+        HRD_ALWAYS_INLINE static mask_type before(mask_type mask, mask_type stop) noexcept {
+            return stop ? (mask & ((stop & (0 - stop)) - 1)) : mask;
+        }
+    };
+
+    HRD_ALWAYS_INLINE static size_t ctz(uint32_t v) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long idx;
+        _BitScanForward(&idx, v);
+        return idx;
+#else
+        return __builtin_ctz(v);
+#endif
+    }
+
+    /**
+     * offset of the first used mark starting from p, it must exist (elements counter checked by caller).
+     * Group loads never pass that mark by more than WIDTH-1 bytes: stay inside mark array + storage allocation
+     */
+    HRD_ALWAYS_INLINE static size_t next_used(const std::byte* p) noexcept {
+        for (size_t i = 0;; i += mark_group::WIDTH) {
+            if (auto m = mark_group(p + i).used())
+                return i + ctz(m);
+        }
+    }
+
+    /**
      * \params ppow2 - equal "(power of 2) - 1"
+     * mark array never smaller than mark_group::WIDTH (aligned group load always inside)
      */
     template<typename this_type>
     HRD_ALWAYS_INLINE constexpr static size_t align_ppow2(size_t ppow2) noexcept {
-        return (((ppow2 + 8) & ~7) + alignof(typename this_type::storage_type) - 1) & ~(alignof(typename this_type::storage_type) - 1);
+        return (((ppow2 < mark_group::WIDTH) ? mark_group::WIDTH : (ppow2 + 1)) + alignof(typename this_type::storage_type) - 1) & ~(alignof(typename this_type::storage_type) - 1);
     }
 
     template<class T>
@@ -201,7 +579,85 @@ protected:
 
     template<size_t SIZE>
     static size_t hash_1(const void* ptr) noexcept {
+#if HRD_FNV_HASH
         return fnv_1a((const char*)ptr, SIZE);
+#else
+        return hash_bytes(ptr, SIZE);
+#endif
+    }
+
+    //first EMPTY_MARK slot of the probe sequence started from h
+    HRD_ALWAYS_INLINE static size_t empty_pos_(const std::byte* marks, size_t capacity, size_t h) noexcept
+    {
+        const auto lanes = mark_group::lanes(capacity);
+        size_t pos = h & capacity;
+        auto skip = mark_group::from(pos);
+
+        for (pos = mark_group::base(pos);; pos = (pos + mark_group::WIDTH) & capacity)
+        {
+            if (auto empty = mark_group(marks + pos).match(EMPTY_MARK) & lanes & skip)
+                return pos + ctz(empty);
+            skip = ~mark_group::mask_type(0);
+        }
+    }
+
+    //index of the element equal to k or SIZE_MAX if absent
+    template<typename key_type, class this_type>
+    HRD_ALWAYS_INLINE size_t find_pos_(const key_type& k, size_t h, const this_type& ref) const noexcept
+    {
+        auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
+        const auto lanes = mark_group::lanes(_capacity);
+        const std::byte mark = make_mark(h);
+        size_t pos = h & _capacity;
+        auto skip = mark_group::from(pos);
+
+        for (pos = mark_group::base(pos);; pos = (pos + mark_group::WIDTH) & _capacity)
+        {
+            mark_group g(_elements + pos);
+            auto empty = g.match(EMPTY_MARK) & lanes & skip;
+            for (auto used = mark_group::before(g.match(mark) & lanes & skip, empty); used; used &= used - 1)
+            {
+                size_t i = pos + ctz(used);
+                if (HRD_LIKELY(ref(this_type::key_getter::get_key(ee[i].data), k))) //identical found
+                    return i;
+            }
+            if (empty)
+                return SIZE_MAX;
+            skip = ~mark_group::mask_type(0);
+        }
+    }
+
+    /** Probe for k: {index of equal element, true} if found or {index to place k, false} otherwise.
+     * First DELETED_MARK slot of the chain reused if ERASE_SUPPORTED.
+     */
+    template<typename key_type, class this_type, typename ERASE_SUPPORTED>
+    HRD_ALWAYS_INLINE std::pair<size_t, bool> insert_pos_(const key_type& k, size_t h, const this_type& ref, ERASE_SUPPORTED) const noexcept
+    {
+        auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
+        const auto lanes = mark_group::lanes(_capacity);
+        const std::byte mark = make_mark(h);
+        size_t pos = h & _capacity;
+        auto skip = mark_group::from(pos);
+        size_t empty_spot = SIZE_MAX;
+
+        for (pos = mark_group::base(pos);; pos = (pos + mark_group::WIDTH) & _capacity)
+        {
+            mark_group g(_elements + pos);
+            auto empty = g.match(EMPTY_MARK) & lanes & skip;
+            for (auto used = mark_group::before(g.match(mark) & lanes & skip, empty); used; used &= used - 1)
+            {
+                size_t i = pos + ctz(used);
+                if (HRD_LIKELY(ref(this_type::key_getter::get_key(ee[i].data), k))) //identical found
+                    return std::pair<size_t, bool>(i, true);
+            }
+            if (ERASE_SUPPORTED::value && empty_spot == SIZE_MAX) {
+                if (auto deleted = mark_group::before(g.match(DELETED_MARK) & lanes & skip, empty))
+                    empty_spot = pos + ctz(deleted); //use first found empty_spot
+            }
+            if (empty)
+                return std::pair<size_t, bool>((empty_spot != SIZE_MAX) ? empty_spot : (pos + ctz(empty)), false);
+            skip = ~mark_group::mask_type(0);
+        }
     }
 
     //space must be allocated before
@@ -210,26 +666,233 @@ protected:
     {
         using storage_type = typename std::remove_reference<V>::type;
 
-        for (size_t i = ref(this_type::key_getter::get_key(st.data));; ++i)
+        size_t h = ref(this_type::key_getter::get_key(st.data));
+        size_t i = empty_pos_(_elements, _capacity, h);
+        new ((void*)(this_elements + i)) storage_type(std::forward<V>(st));
+        _elements[i] = make_mark(h);
+        _size++;
+    }
+
+    /**
+     * Move elements of "count" slots started from "pos" to dst, space must be allocated and keys be absent there.
+     * Freed slots marked as DELETED_MARK to keep probe chains of the rest. Returns next slot to visit
+     */
+    template<typename this_type>
+    size_t move_slots_(this_type& dst, size_t pos, size_t count)
+    {
+        using VT = typename this_type::value_type;
+
+        auto* src_ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
+        auto* dst_ee = reinterpret_cast<typename this_type::storage_type*>(dst._elements + align_ppow2<this_type>(dst._capacity));
+
+        for (; count-- && _size; pos = (pos + 1) & _capacity)
         {
-            i &= _capacity;
-            auto r = this_elements + i;
-            if (EMPTY_MARK == _elements[i]) {
-                new ((void*)r) storage_type(std::forward<V>(st));
-                _elements[i] = USED_MARK;
-                _size++;
-                return;
+            if (is_used(_elements[pos])) {
+                dst.insert_unique(std::move(src_ee[pos]), dst, dst_ee, std::false_type());
+                src_ee[pos].data.~VT();
+                _elements[pos] = DELETED_MARK;
+                _erased++;
+                _size--;
+            }
+        }
+        return pos;
+    }
+
+    /**
+     * Multithreaded placement of "nsrc" source items to empty marks of "mask + 1" slots, see HRD_REHASH_THREADS.
+     * Storage split to regions by high bits of home slot.
+     * 1: every thread calls scan(first, last, emit) for own source range, emit(hash, source index) buckets them by region,
+     * 2: every thread places items of own regions probing inside them only, 3: items whose probe crossed region end placed serially.
+     * probe(h, src, pos, end) returns first free slot of [pos, end), "end" if absent or SIZE_MAX to skip the item (duplicate),
+     * put(slot, h, src) constructs element and its mark. Exception from put stops placement, "placed" is actual anyway.
+     */
+    template<typename Scan, typename Probe, typename Put>
+    static void place_parallel_(size_t mask, size_t nsrc, size_t nthreads, size_t& placed, Scan scan, Probe probe, Put put)
+    {
+        using bucket_type = std::vector<std::pair<size_t, size_t>>; //hash, source index
+
+        const size_t pow2 = mask + 1;
+        size_t regions = 1;
+        while (regions < 4 * nthreads && pow2 / (regions * 2) >= 16 * mark_group::WIDTH)
+            regions <<= 1;
+        const size_t region_size = pow2 / regions;
+
+        std::vector<bucket_type> buckets(nthreads * regions);
+        run_parallel_(nsrc, nthreads, [&](size_t part, size_t first, size_t last) {
+            auto* own = &buckets[part * regions];
+            scan(first, last, [&](size_t h, size_t src) { own[(h & mask) / region_size].emplace_back(h, src); });
+        });
+
+        //no allocations from this point, placed items marked by SIZE_MAX source
+        std::vector<size_t> counts(nthreads); //reserved before any placement
+        std::atomic<bool> put_failed{ false };
+        try {
+            run_parallel_(regions, nthreads, [&](size_t part, size_t first, size_t last) {
+                size_t cnt = 0;
+                try {
+                    for (size_t r = first; r < last; ++r) {
+                        const size_t end = (r + 1) * region_size;
+                        for (size_t t = 0; t < nthreads; ++t) {
+                            for (auto& e : buckets[t * regions + r]) {
+                                size_t i = probe(e.first, e.second, e.first & mask, end);
+                                if (HRD_UNLIKELY(i == end))
+                                    continue;
+                                if (i != SIZE_MAX) {
+                                    put(i, e.first, e.second);
+                                    ++cnt;
+                                }
+                                e.second = SIZE_MAX;
+                            }
+                        }
+                    }
+                }
+                catch (...) {
+                    counts[part] = cnt;
+                    put_failed = true;
+                    throw;
+                }
+                counts[part] = cnt;
+            }, 1);
+        }
+        catch (...) {
+            if (put_failed) {
+                for (auto c : counts)
+                    placed += c;
+                throw;
+            }
+            //thread start failed: regions of not started threads untouched, placed by the serial pass below
+        }
+        for (auto c : counts)
+            placed += c;
+
+        for (auto& bucket : buckets) {
+            for (auto& e : bucket) {
+                if (HRD_UNLIKELY(e.second != SIZE_MAX)) {
+                    size_t home = e.first & mask;
+                    size_t i = probe(e.first, e.second, home, pow2);
+                    if (i == pow2)
+                        i = probe(e.first, e.second, 0, home);
+                    if (i != SIZE_MAX) {
+                        put(i, e.first, e.second);
+                        ++placed;
+                    }
+                }
             }
         }
     }
 
+    //multithreaded resize_pow2_impl for nothrow movable data, false if table is small (nothing done then)
+    template<typename this_type>
+    bool resize_pow2_parallel_(size_t pow2, const this_type& ref)
+    {
+        using storage_type = typename this_type::storage_type;
+
+        size_t nthreads = threads_count_(HRD_REHASH_THREADS);
+        if (nthreads < 2 || _size < (size_t)HRD_PARALLEL_REHASH_MIN || pow2 < 64 * mark_group::WIDTH ||
+            !(this_type::IS_TRIVIALLY_COPYABLE::value || std::is_nothrow_move_constructible<decltype(storage_type::data)>::value))
+            return false;
+
+        size_t bt_size = align_ppow2<this_type>(--pow2);
+
+        auto* data = allocate_<this_type>(pow2);
+        if (HRD_UNLIKELY(!data))
+            throw_bad_alloc();
+        memset(data, 0, bt_size);
+
+        auto* src_ee = data_<this_type>();
+        auto* dst_ee = (storage_type*)(data + bt_size);
+        size_t placed = 0;
+
+        try {
+            place_parallel_(pow2, _capacity + 1, nthreads, placed,
+                [&](size_t first, size_t last, auto&& emit) {
+                    for (size_t g = first; g < last; g += mark_group::WIDTH) {
+                        auto m = mark_group(_elements + g).used();
+                        if (last - g < mark_group::WIDTH)
+                            m &= (typename mark_group::mask_type(1) << (last - g)) - 1;
+                        for (; m; m &= m - 1) {
+                            size_t i = g + ctz(m);
+                            emit(ref(this_type::key_getter::get_key(src_ee[i].data)), i);
+                        }
+                    }
+                },
+                [&](size_t, size_t, size_t pos, size_t end) noexcept {
+                    while (pos < end && is_used(data[pos]))
+                        ++pos;
+                    return pos;
+                },
+                [&](size_t i, size_t h, size_t src) noexcept {
+                    move_slot_(dst_ee + i, src_ee + src, typename this_type::IS_TRIVIALLY_COPYABLE());
+                    data[i] = make_mark(h);
+                });
+        }
+        catch (...) { //hashing or bucketing failed, nothing moved
+            deallocate_<this_type>(data, pow2);
+            throw;
+        }
+
+        deallocate_<this_type>(_elements, _capacity);
+        _capacity = pow2;
+        _erased = 0;
+        _gap = (size_type)(DEFAULT_LOAD_FACTOR * (pow2 + 1));
+        _elements = data;
+        return true;
+    }
+
+    /**
+     * Multithreaded insert_iters_ to just allocated empty storage, false if range is small (nothing done then).
+     * Duplicated keys processed in range order: first one inserted like in serial case
+     */
+    template<typename Iter, class this_type>
+    bool ctor_iters_parallel_(Iter first, size_t n, this_type& ref)
+    {
+        using value_type = typename this_type::value_type;
+
+        size_t nthreads = threads_count_(HRD_REHASH_THREADS);
+        if (nthreads < 2 || n < (size_t)HRD_PARALLEL_REHASH_MIN || _capacity + 1 < 64 * mark_group::WIDTH)
+            return false;
+
+        auto* ee = data_<this_type>();
+        size_t placed = 0;
+        try {
+            place_parallel_(_capacity, n, nthreads, placed,
+                [&](size_t from, size_t to, auto&& emit) {
+                    for (size_t i = from; i < to; ++i)
+                        emit(ref(this_type::key_getter::get_key(first[i])), i);
+                },
+                [&](size_t h, size_t src, size_t pos, size_t end) {
+                    const std::byte mark = make_mark(h);
+                    for (; pos < end; ++pos) {
+                        if (!is_used(_elements[pos]))
+                            return pos;
+                        //get_key(first[src]) can return reference to temporary converted value: not kept
+                        if (_elements[pos] == mark && ref(this_type::key_getter::get_key(ee[pos].data), this_type::key_getter::get_key(first[src])))
+                            return SIZE_MAX;
+                    }
+                    return end;
+                },
+                [&](size_t i, size_t h, size_t src) {
+                    new ((void*)&ee[i].data) value_type(first[src]);
+                    _elements[i] = make_mark(h);
+                });
+        }
+        catch (...) {
+            _size = placed; //constructed ones destroyed by caller
+            throw;
+        }
+        _size = placed;
+        return true;
+    }
+
     template<typename this_type>
     void resize_pow2_impl(size_t pow2, const this_type& ref, std::true_type /*trivial data*/)
     {
-        size_t el_size = sizeof(typename this_type::storage_type) * pow2--;
-        size_t bt_size = align_ppow2<this_type>(pow2); //8 bytes for marks minimum
+        if (resize_pow2_parallel_(pow2, ref))
+            return;
+
+        size_t bt_size = align_ppow2<this_type>(--pow2); //8 bytes for marks minimum
 
-        auto* data = (std::byte*)malloc(bt_size + el_size);
+        auto* data = allocate_<this_type>(pow2);
         if (HRD_UNLIKELY(!data))
             throw_bad_alloc();
 
@@ -242,28 +905,21 @@ protected:
         {
             for (size_t pos = 0;; ++pos)
             {
-                if (HRD_UNLIKELY(USED_MARK == _elements[pos]))
-                {
-                    auto src = src_ee + pos;
-
-                    for (size_t i = ref(this_type::key_getter::get_key(src->data));; ++i)
-                    {
-                        i &= pow2;
-
-                        if (HRD_LIKELY(EMPTY_MARK == data[i])) {
-                            data[i] = USED_MARK;
-                            memcpy((void*)(dst_ee + i), src, sizeof(typename this_type::storage_type));
-                            break;
-                        }
-                    }
-                    if (!--cnt)
-                        break;
-                }
+                pos += next_used(_elements + pos);
+                auto src = src_ee + pos;
+
+                size_t h = ref(this_type::key_getter::get_key(src->data));
+                size_t i = empty_pos_(data, pow2, h);
+                data[i] = make_mark(h);
+                memcpy((void*)(dst_ee + i), src, sizeof(typename this_type::storage_type));
+
+                if (!--cnt)
+                    break;
             }
         }
 
         if (_capacity)
-            free(_elements);
+            deallocate_<this_type>(_elements, _capacity);
         _capacity = pow2;
         _erased = 0;
 		_gap = (size_type)(DEFAULT_LOAD_FACTOR * (pow2 + 1));
@@ -273,7 +929,10 @@ protected:
     template<typename this_type>
     void resize_pow2_impl(size_t pow2, const this_type& ref, std::false_type /*non-trivial data*/)
     {
-        this_type tmp(pow2--, false);
+        if (resize_pow2_parallel_(pow2, ref))
+            return;
+
+        this_type tmp(pow2--, false, static_cast<const this_type*>(this)->get_allocator());
         if (HRD_LIKELY(_size)) //rehash
         {
             auto* src_ee = (typename this_type::storage_type*)(_elements + align_ppow2<this_type>(_capacity));
@@ -281,20 +940,19 @@ protected:
 
             for (size_t i = 0;; ++i)
             {
-                if (HRD_UNLIKELY(USED_MARK == _elements[i])) {
-                    using VT = typename this_type::value_type ;
+                i += next_used(_elements + i);
+                using VT = typename this_type::value_type ;
 
-                    VT& r = src_ee[i].data;
-                    tmp.insert_unique(std::move(src_ee[i]), ref, dst_ee, std::false_type());
-                    r.~VT();
+                VT& r = src_ee[i].data;
+                tmp.insert_unique(std::move(src_ee[i]), ref, dst_ee, std::false_type());
+                r.~VT();
 
-                    //next 2 lines to cover any exception that occurs during next tmp.insert_unique(std::move(r));
-                    _elements[i] = DELETED_MARK;
-                    _erased++;
+                //next 2 lines to cover any exception that occurs during next tmp.insert_unique(std::move(r));
+                _elements[i] = DELETED_MARK;
+                _erased++;
 
-                    if (!--_size)
-                        break;
-                }
+                if (!--_size)
+                    break;
             }
             _size = tmp._size;
             tmp._size = 0; //prevent elements dtor call
@@ -375,10 +1033,9 @@ protected:
             {
                 if (HRD_LIKELY(_cnt)) {
                     --_cnt;
-                    auto sv = _mark;
-                    while (HRD_LIKELY(*(++_mark) != base::USED_MARK))
-                        ;
-                    _ptr += (_mark - sv);
+                    size_t step = 1 + hash_base::next_used(_mark + 1);
+                    _mark += step;
+                    _ptr += step;
                 }
                 else
                     _ptr = nullptr;
@@ -434,12 +1091,10 @@ protected:
     template<typename this_type>
     HRD_ALWAYS_INLINE void ctor_copy(std::true_type, const this_type& ref) //IS_TRIVIALLY_COPYABLE
     {
-        using StorageType = typename this_type::storage_type;
-
         if (HRD_LIKELY(ref._size))
         {
-            size_t len = align_ppow2<this_type>(ref._capacity) + (ref._capacity + 1) * sizeof(StorageType);
-            _elements = (std::byte*)malloc(len);
+            size_t len = block_size_<this_type>(ref._capacity);
+            _elements = allocate_<this_type>(ref._capacity);
             if (HRD_LIKELY(!!_elements)) {
                 memcpy(_elements, ref._elements, len);
                 _size = ref._size;
@@ -466,11 +1121,10 @@ protected:
 
         for (size_t i = 0;; ++i)
         {
-            if (HRD_UNLIKELY(ref._elements[i] == USED_MARK)) {
-                insert_unique(src_ee[i], ref, dst_ee, std::false_type());
-                if (HRD_UNLIKELY(!--cnt))
-                    break;
-            }
+            i += next_used(ref._elements + i);
+            insert_unique(src_ee[i], ref, dst_ee, std::false_type());
+            if (HRD_UNLIKELY(!--cnt))
+                break;
         }
     }
 
@@ -506,7 +1160,7 @@ protected:
     template<typename this_type>
     HRD_ALWAYS_INLINE void ctor_init_list(std::initializer_list<typename this_type::value_type> lst, this_type& ref)
     {
-        ctor_pow2<this_type>(calc_pow2(lst.size()), sizeof(typename this_type::storage_type));
+        ctor_pow2<this_type>(calc_pow2(lst.size()));
         dtor_if_throw_constructible<this_type> tmp(ref);
         ctor_insert_(lst.begin(), lst.end(), ref, std::true_type());
 
@@ -519,22 +1173,15 @@ protected:
         size_t bt_size = align_ppow2<this_type>(_capacity);
         auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + bt_size);
 
-        for (size_t i = ref(this_type::key_getter::get_key(val));; ++i)
+        size_t h = ref(this_type::key_getter::get_key(val));
+        auto pos = insert_pos_(this_type::key_getter::get_key(val), h, ref, std::false_type());
+        if (!pos.second)
         {
-            i &= _capacity;
-            auto* r = ee + i;
-            int32_t h = _elements[i];
-            if (!h)
-            {
-                using value_type = typename this_type::value_type;
+            using value_type = typename this_type::value_type;
 
-                new ((void*)&r->data) value_type(std::forward<V>(val));
-                _elements[i] = USED_MARK;
-                _size++;
-                return;
-            }
-            if (h == USED_MARK && HRD_LIKELY(ref(this_type::key_getter::get_key(r->data), this_type::key_getter::get_key(val)))) //identical found
-                return;
+            new ((void*)&ee[pos.first].data) value_type(std::forward<V>(val));
+            _elements[pos.first] = make_mark(h);
+            _size++;
         }
     }
 
@@ -556,9 +1203,11 @@ protected:
     template<typename Iter, class this_type>
     HRD_ALWAYS_INLINE void ctor_iters(Iter first, Iter last, this_type& ref, std::random_access_iterator_tag)
     {
-        ctor_pow2<this_type>(calc_pow2(std::distance(first, last)), sizeof(typename this_type::storage_type));
+        size_t n = std::distance(first, last);
+        ctor_pow2<this_type>(calc_pow2(n));
         dtor_if_throw_constructible<this_type> tmp(ref);
-        ctor_insert_(first, last, ref, std::true_type());
+        if (!ctor_iters_parallel_(first, n, ref))
+            insert_iters_(first, last, ref, std::true_type(), std::false_type());
 
         tmp.reset();
     }
@@ -573,10 +1222,31 @@ protected:
         tmp.reset();
     }
 
-    template <typename Iter, class this_type, typename SIZE_PREPARED, typename ERASE_SUPPORTED>
-    void insert_iters_(Iter first, Iter last, this_type& ref, SIZE_PREPARED, ERASE_SUPPORTED) {
+    template <typename Iter, class this_type, typename ERASE_SUPPORTED>
+    void insert_iters_(Iter first, Iter last, this_type& ref, std::false_type /*size not prepared*/, ERASE_SUPPORTED) {
         for (; first != last; ++first)
-            insert_(*first, ref, SIZE_PREPARED(), ERASE_SUPPORTED());
+            insert_(*first, ref, std::false_type(), ERASE_SUPPORTED());
+    }
+
+    //space allocated before: keys of a batch hashed and their home mark/slot prefetched, then placed
+    template <typename Iter, class this_type, typename ERASE_SUPPORTED>
+    void insert_iters_(Iter first, Iter last, this_type& ref, std::true_type /*size prepared*/, ERASE_SUPPORTED)
+    {
+        auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
+        size_t hashes[BATCH_SIZE];
+
+        while (first != last)
+        {
+            size_t cnt = 0;
+            for (Iter it = first; cnt < BATCH_SIZE && it != last; ++it) {
+                size_t h = ref(this_type::key_getter::get_key(*it));
+                hashes[cnt++] = h;
+                prefetch_(_elements + (h & _capacity));
+                prefetch_(ee + (h & _capacity));
+            }
+            for (size_t i = 0; i < cnt; ++i, ++first)
+                insert_hashed_(*first, hashes[i], ref, ERASE_SUPPORTED());
+        }
     }
 
     template<typename Iter, class this_type, typename ERASE_SUPPORTED>
@@ -585,8 +1255,12 @@ protected:
         auto added = std::distance(first, last);
         if (HRD_LIKELY(added)) {
             size_t actual = added + _size;
-            if ((_erased + actual) >= _gap)
-                resize_pow2(calc_pow2(actual), ref);
+            if ((_erased + actual) >= _gap) {
+                if (movable_slots_<this_type>::value && actual < _gap)
+                    compact_(ref);
+                else
+                    resize_pow2(calc_pow2(actual), ref);
+            }
 
             insert_iters_(first, last, ref, std::true_type(), ERASE_SUPPORTED());
         }
@@ -614,7 +1288,7 @@ protected:
         size_t bt_size = align_ppow2<this_type>(pow2 - 1);
         _erased = 0;
 		_gap = (size_type)(DEFAULT_LOAD_FACTOR * pow2);
-        _elements = (std::byte*)malloc(bt_size + sizeof(typename this_type::storage_type) * pow2);
+        _elements = allocate_<this_type>(pow2 - 1);
         if (HRD_LIKELY(!!_elements))
             memset(_elements, 0, bt_size);
         else
@@ -625,7 +1299,7 @@ protected:
     HRD_ALWAYS_INLINE void dtor(std::true_type, this_type*) noexcept
     {
         if (HRD_LIKELY(_capacity))
-            free(_elements);
+            deallocate_<this_type>(_elements, _capacity);
     }
 
     template<class this_type>
@@ -633,37 +1307,126 @@ protected:
 		return (typename this_type::storage_type*)(_elements + align_ppow2<this_type>(_capacity));
     }
 
+    //bytes of marks and slots block, "capacity" is (pow2 - 1)
     template<class this_type>
-    HRD_ALWAYS_INLINE void dtor(std::false_type, this_type*) noexcept
-    {
-        if (auto cnt = _size)
-        {
-            using storage_type = typename this_type::storage_type;
-            using data_type    = typename this_type::value_type;
+    HRD_ALWAYS_INLINE constexpr static size_t block_size_(size_t capacity) noexcept {
+        return align_ppow2<this_type>(capacity) + (capacity + 1) * sizeof(typename this_type::storage_type);
+    }
+
+    //block by allocator of the table, nullptr if failed
+    template<class this_type>
+    HRD_ALWAYS_INLINE std::byte* allocate_(size_t capacity) {
+        auto& alloc = static_cast<typename this_type::allocator_type&>(*static_cast<this_type*>(this));
+        return static_cast<std::byte*>(alloc.allocate(block_size_<this_type>(capacity)));
+    }
+
+    template<class this_type>
+    HRD_ALWAYS_INLINE void deallocate_(std::byte* p, size_t capacity) noexcept {
+        auto& alloc = static_cast<typename this_type::allocator_type&>(*static_cast<this_type*>(this));
+        alloc.deallocate(p, block_size_<this_type>(capacity));
+    }
+
+    static size_t threads_count_(size_t nthreads) noexcept {
+        if (!nthreads)
+            nthreads = std::thread::hardware_concurrency();
+        return nthreads ? nthreads : 1;
+    }
+
+    /**
+     * Split [0, n) to "grain" (power of 2) aligned ranges and call f(part, first, last) for each one in own thread,
+     * calling thread takes the last part. nthreads == 0 means hardware concurrency. First exception rethrown after join.
+     * \return number of parts
+     */
+    template<typename F>
+    static size_t run_parallel_(size_t n, size_t nthreads, F f, size_t grain = mark_group::WIDTH)
+    {
+        nthreads = threads_count_(nthreads);
+        size_t chunk = (n + nthreads - 1) / nthreads;
+        chunk = (chunk + grain - 1) & ~(grain - 1);
+        size_t parts = chunk ? (n + chunk - 1) / chunk : 0;
+        if (parts <= 1) {
+            if (parts)
+                f(size_t(0), size_t(0), n);
+            return parts;
+        }
+
+        std::vector<std::exception_ptr> errors(parts);
+        std::vector<std::thread> pool;
+        pool.reserve(parts - 1);
+        auto job = [&](size_t part) noexcept {
+            try {
+                size_t first = part * chunk;
+                f(part, first, (first + chunk < n) ? first + chunk : n);
+            }
+            catch (...) {
+                errors[part] = std::current_exception();
+            }
+        };
+
+        try {
+            for (size_t part = 0; part + 1 < parts; ++part)
+                pool.emplace_back(job, part);
+        }
+        catch (...) {
+            for (auto& t : pool)
+                t.join();
+            throw;
+        }
+        job(parts - 1);
+        for (auto& t : pool)
+            t.join();
+
+        for (auto& e : errors)
+            if (HRD_UNLIKELY(!!e))
+                std::rethrow_exception(e);
+        return parts;
+    }
+
+    //call f(value) for used slots in [first, last), "first" aligned to mark_group::WIDTH
+    template<class this_type, typename F>
+    void for_each_range_(size_t first, size_t last, F& f) const
+    {
+        const auto* ee = data_<this_type>();
+        for (size_t g = first; g < last; g += mark_group::WIDTH) {
+            auto m = mark_group(_elements + g).used();
+            if (last - g < mark_group::WIDTH)
+                m &= (typename mark_group::mask_type(1) << (last - g)) - 1;
+            for (; m; m &= m - 1) {
+                size_t i = g + ctz(m);
+                f(static_cast<const decltype(ee[i].data)&>(ee[i].data));
+            }
+        }
+    }
+
+    template<class this_type>
+    HRD_ALWAYS_INLINE void dtor(std::false_type, this_type*) noexcept
+    {
+        if (auto cnt = _size)
+        {
+            using storage_type = typename this_type::storage_type;
+            using data_type    = typename this_type::value_type;
 
             auto* ee = reinterpret_cast<storage_type*>(_elements + align_ppow2<this_type>(_capacity));
 
             for (size_t i = 0;; ++i)
             {
-                if (HRD_UNLIKELY(_elements[i] == USED_MARK)) {
-                    cnt--;
-                    ee[i].data.~data_type();
-                    if (HRD_UNLIKELY(!cnt))
-                        break;
-                }
+                i += next_used(_elements + i);
+                ee[i].data.~data_type();
+                if (HRD_UNLIKELY(!--cnt))
+                    break;
             }
         }
         else if (!_capacity)
             return;
 
-        free(_elements);
+        deallocate_<this_type>(_elements, _capacity);
     }
 
     template<class this_type>
     HRD_ALWAYS_INLINE void clear(std::true_type) noexcept
     {
         if (HRD_LIKELY(_capacity)) {
-            free(_elements);
+            deallocate_<this_type>(_elements, _capacity);
             ctor_empty();
         }
     }
@@ -675,189 +1438,153 @@ protected:
     }
 
     //all needed space should be allocated before
-    template<typename V, class this_type>
-    HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, this_type& ref, std::true_type, std::true_type)
+    template<typename V, class this_type, typename ERASE_SUPPORTED>
+    HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, this_type& ref, std::true_type, ERASE_SUPPORTED)
     {
-        size_t empty_spot = SIZE_MAX;
-        auto match_mark = DELETED_MARK;
+        size_t h = ref(this_type::key_getter::get_key(val));
+        return insert_hashed_(std::forward<V>(val), h, ref, ERASE_SUPPORTED());
+    }
 
+    //all needed space should be allocated before, h - hash of val key
+    template<typename V, class this_type, typename ERASE_SUPPORTED>
+    HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_hashed_(V&& val, size_t h, this_type& ref, ERASE_SUPPORTED)
+    {
         using iter = typename this_type::iterator;
         auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
 
-        for (size_t i = ref(this_type::key_getter::get_key(val));; ++i)
-        {
-            i &= _capacity;
-
-            auto* r = ee + i;
+        auto pos = insert_pos_(this_type::key_getter::get_key(val), h, ref, ERASE_SUPPORTED());
+        auto* r = ee + pos.first;
+        if (pos.second) //identical found
+            return std::pair<iter, bool>(iter(r, _elements + pos.first), false);
 
-            auto h = _elements[i];
-            if (EMPTY_MARK == h)
-            {
-                if (HRD_UNLIKELY(empty_spot != SIZE_MAX)) {
-                    r = ee + empty_spot;
-                    i = empty_spot;
-                }
+        using value_type = typename this_type::value_type;
 
-                using value_type = typename this_type::value_type;
-
-                std::pair<iter, bool> ret(iter(r, _elements + i), true);
-                new ((void*)&r->data) value_type(std::forward<V>(val));
-                _elements[i] = USED_MARK;
-                _size++;
-                if (HRD_UNLIKELY(empty_spot != SIZE_MAX)) _erased--;
-                return ret;
-            }
-            if (USED_MARK == h)
-            {
-                if (HRD_LIKELY(ref(this_type::key_getter::get_key(r->data), this_type::key_getter::get_key(val)))) //identical found
-                    return std::pair<iter, bool>(iter(r, _elements + i), false);
-            }
-            else if (match_mark == h) {
-                match_mark = EMPTY_MARK; //use first found empty_spot
-                empty_spot = i;
-            }
-        }
+        new ((void*)&r->data) value_type(std::forward<V>(val));
+        if (HRD_UNLIKELY(DELETED_MARK == _elements[pos.first])) _erased--;
+        _elements[pos.first] = make_mark(h);
+        _size++;
+        return std::pair<iter, bool>(iter(r, _elements + pos.first), true);
     }
-	
-    //all needed space should be allocated before
-	template<typename V, class this_type>
-	HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, this_type& ref, std::true_type, std::false_type)
-	{
-		using iter = typename this_type::iterator;
-		auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
-
-		for (size_t i = ref(this_type::key_getter::get_key(val));; ++i)
-		{
-			i &= _capacity;
-
-			auto* r = ee + i;
-
-			auto h = _elements[i];
-			if (EMPTY_MARK == h)
-			{
-				using value_type = typename this_type::value_type;
-
-				std::pair<iter, bool> ret(iter(r, _elements + i), true);
-				new ((void*)&r->data) value_type(std::forward<V>(val));
-				_elements[i] = USED_MARK;
-				_size++;
-				return ret;
-			}
-			if (HRD_LIKELY(ref(this_type::key_getter::get_key(r->data), this_type::key_getter::get_key(val)))) //identical found
-				return std::pair<iter, bool>(iter(r, _elements + i), false);
-		}
-	}
 
     //probe available size each time
+    template<typename V, class this_type, typename ERASE_SUPPORTED>
+    HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, this_type& ref, std::false_type, ERASE_SUPPORTED)
+    {
+        size_t h = ref(this_type::key_getter::get_key(val));
+        return insert_(std::forward<V>(val), h, ref, std::false_type(), ERASE_SUPPORTED());
+    }
+
+    //probe available size each time, h - hash of val key
     template<typename V, class this_type>
-    HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, this_type& ref, std::false_type, std::true_type)
+    HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, size_t h, this_type& ref, std::false_type, std::true_type)
     {
         size_t used = _erased + _size;
         if (HRD_UNLIKELY(used >= _gap))
-            resize_pow2(2 * (_capacity + 1), ref);
+            grow_(ref);
 
-        return insert_(std::forward<V>(val), ref, std::true_type(), std::true_type());
+        return insert_hashed_(std::forward<V>(val), h, ref, std::true_type());
     }
 
-	//probe available size each time
+	//probe available size each time, h - hash of val key
 	template<typename V, class this_type>
-	HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, this_type& ref, std::false_type, std::false_type)
+	HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, size_t h, this_type& ref, std::false_type, std::false_type)
 	{
 		if (HRD_UNLIKELY(_size >= _gap))
 			resize_pow2(2 * (_capacity + 1), ref);
 
-		return insert_(std::forward<V>(val), ref, std::true_type(), std::false_type());
+		return insert_hashed_(std::forward<V>(val), h, ref, std::false_type());
 	}
 
-    template<typename key_type, class this_type>
-    HRD_ALWAYS_INLINE typename this_type::storage_type* find_(const key_type& k, const this_type& ref, std::true_type) const noexcept
-    {
-        auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
+    //std::true_type - table with erase support (DELETED_MARK possible), std::false_type - grow only, both probe up to first EMPTY_MARK
+    template<typename key_type, class this_type, typename ERASE_SUPPORTED>
+    HRD_ALWAYS_INLINE typename this_type::storage_type* find_(const key_type& k, const this_type& ref, ERASE_SUPPORTED) const noexcept {
+        return find_(k, ref(k), ref, ERASE_SUPPORTED());
+    }
 
-        for (size_t i = ref(k);;++i)
-        {
-            i &= _capacity;
+    //h - hash of k
+    template<typename key_type, class this_type, typename ERASE_SUPPORTED>
+    HRD_ALWAYS_INLINE typename this_type::storage_type* find_(const key_type& k, size_t h, const this_type& ref, ERASE_SUPPORTED) const noexcept
+    {
+        size_t i = find_pos_(k, h, ref);
+        if (i == SIZE_MAX)
+            return nullptr;
+        return reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity)) + i;
+    }
 
-            auto h = _elements[i];
-            if (USED_MARK == h) {
-                auto& r = ee[i];
-                if (HRD_LIKELY(ref(this_type::key_getter::get_key(r.data), k))) //identical found
-                    return &r;
-            }
-            else if (EMPTY_MARK == h)
-                return nullptr;
-        }
+    template<typename key_type, class this_type, typename ERASE_SUPPORTED>
+    HRD_ALWAYS_INLINE typename this_type::iterator find_iter_(const key_type& k, const this_type& ref, ERASE_SUPPORTED) const noexcept {
+        return find_iter_(k, ref(k), ref, ERASE_SUPPORTED());
     }
 
-	template<typename key_type, class this_type>
-	HRD_ALWAYS_INLINE typename this_type::storage_type* find_(const key_type& k, const this_type& ref, std::false_type) const noexcept
-	{
-		auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
+    template<typename key_type, class this_type, typename ERASE_SUPPORTED>
+    HRD_ALWAYS_INLINE typename this_type::iterator find_iter_(const key_type& k, size_t h, const this_type& ref, ERASE_SUPPORTED) const noexcept
+    {
+        using iter = typename this_type::iterator;
 
-		for (size_t i = ref(k);; ++i)
-		{
-			i &= _capacity;
+        size_t i = find_pos_(k, h, ref);
+        if (i == SIZE_MAX)
+            return iter();
+        auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
+        return iter(ee + i, _elements + i, 0);
+    }
 
-			if (USED_MARK == _elements[i]) {
-				auto& r = ee[i];
-				if (HRD_LIKELY(ref(this_type::key_getter::get_key(r.data), k))) //identical found
-					return &r;
-			}
-            else
-			    return nullptr;
-		}
-	}
+    //keys of one batch hashed and their home mark/slot prefetched before probing, misses of different keys overlapped
+    constexpr static const size_t BATCH_SIZE = 16;
 
-    template<typename key_type, class this_type>
-    HRD_ALWAYS_INLINE typename this_type::iterator find_iter_(const key_type& k, const this_type& ref, std::true_type) const noexcept
+    HRD_ALWAYS_INLINE static void prefetch_(const void* p) noexcept {
+        _mm_prefetch((const char*)p, _MM_HINT_T0);
+    }
+
+    //f(i) called for every key of [first, last) in order, i - index of found element or SIZE_MAX. Iter must be multi-pass
+    template<typename Iter, class this_type, typename F>
+    HRD_ALWAYS_INLINE void find_batch_(Iter first, Iter last, const this_type& ref, F&& f) const
     {
-        using iter = typename this_type::iterator;
         auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
+        size_t hashes[BATCH_SIZE];
 
-        for (size_t i = ref(k);; ++i)
+        while (first != last)
         {
-            i &= _capacity;
-
-            auto h = _elements[i];
-            if (USED_MARK == h) {
-                auto& r = ee[i];
-                if (HRD_LIKELY(ref(this_type::key_getter::get_key(r.data), k))) { //identical found
-                    return iter(&r, _elements + i, 0);
-                }
+            size_t cnt = 0;
+            for (Iter it = first; cnt < BATCH_SIZE && it != last; ++it) {
+                size_t h = ref(*it);
+                hashes[cnt++] = h;
+                prefetch_(_elements + (h & _capacity));
+                prefetch_(ee + (h & _capacity));
             }
-            else if (EMPTY_MARK == h)
-                return iter();
+            for (size_t i = 0; i < cnt; ++i, ++first)
+                f(find_pos_(*first, hashes[i], ref));
         }
     }
 
-	template<typename key_type, class this_type>
-	HRD_ALWAYS_INLINE typename this_type::iterator find_iter_(const key_type& k, const this_type& ref, std::false_type) const noexcept
-	{
-		using iter = typename this_type::iterator;
-		auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
-
-		for (size_t i = ref(k);; ++i)
-		{
-			i &= _capacity;
-
-			if (USED_MARK == _elements[i]) {
-				auto& r = ee[i];
-				if (HRD_LIKELY(ref(this_type::key_getter::get_key(r.data), k))) { //identical found
-					return iter(&r, _elements + i, 0);
-				}
-			}
-            else
-			    return iter();
-		}
-	}
+    //iter - iterator or const_iterator of this_type written to out
+    template<typename iter, typename Iter, typename Out, class this_type>
+    HRD_ALWAYS_INLINE Out find_many_(Iter first, Iter last, Out out, const this_type& ref) const
+    {
+        auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
+
+        find_batch_(first, last, ref, [&](size_t i) {
+            *out++ = (i != SIZE_MAX) ? iter(ee + i, _elements + i, 0) : iter();
+        });
+        return out;
+    }
+
+    template<typename Iter, typename Out, class this_type>
+    HRD_ALWAYS_INLINE size_type contains_many_(Iter first, Iter last, Out out, const this_type& ref) const
+    {
+        size_type found = 0;
+        find_batch_(first, last, ref, [&](size_t i) {
+            found += (i != SIZE_MAX);
+            *out++ = (i != SIZE_MAX);
+        });
+        return found;
+    }
 
     template <class this_type>
     HRD_ALWAYS_INLINE typename this_type::iterator erase_(typename this_type::const_iterator& it) noexcept
     {
         auto& ret = (typename this_type::iterator&)it;
 
-        auto idx = it._mark - _elements;
-        auto e_next = _elements + ((idx + 1) & _capacity);
+        size_t idx = it._mark - _elements;
 
         if (HRD_LIKELY(!!it._ptr)) //valid
         {
@@ -865,64 +1592,179 @@ protected:
 
             it._ptr->data.~data_type();
             _size--;
-
-            //set DELETED_MARK only if next element not 0
-            auto mark = *e_next;
-            if (HRD_LIKELY(EMPTY_MARK == mark))
-                _elements[idx] = EMPTY_MARK;
-            else {
-                _elements[idx] = DELETED_MARK;
-                _erased++;
-            }
+            free_slot_(idx, *static_cast<this_type*>(this));
 
             if (HRD_UNLIKELY(ret._cnt)) {
                 auto sv = ret._mark;
-                for (--ret._cnt;;) {
-                    if (HRD_UNLIKELY(*(++ret._mark) == USED_MARK)) {
-                        ret._ptr += (ret._mark - sv);
-                        return ret;
-                    }
-                }
+                --ret._cnt;
+                size_t step = next_used(sv); //0 if next element shifted to the erased one place
+                ret._mark += step;
+                ret._ptr += step;
+                return ret;
             }
             it._ptr = nullptr;
         }
         return ret;
     }
 
+    template <typename key_type, class this_type>
+    HRD_ALWAYS_INLINE size_type erase_(const key_type& k, this_type& ref) noexcept {
+        return erase_(k, ref(k), ref);
+    }
+
+    template <typename key_type, class this_type>
+    HRD_ALWAYS_INLINE size_type erase_(const key_type& k, size_t h, this_type& ref) noexcept
+    {
+        size_t i = find_pos_(k, h, ref);
+        if (i == SIZE_MAX)
+            return 0;
+
+        using data_type = typename this_type::value_type;
+
+        auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
+        ee[i].data.~data_type();
+        _size--;
+        free_slot_(i, ref);
+
+        return 1;
+    }
+
+    //elements can be moved between slots of the same storage without losing any (backward shift, in-place compaction)
+    template <class this_type>
+    using movable_slots_ = std::integral_constant<bool,
+        this_type::IS_TRIVIALLY_COPYABLE::value || std::is_nothrow_move_constructible<typename this_type::value_type>::value>;
+
+    //mark slot i of just destroyed element as free
+    template <class this_type>
+    HRD_ALWAYS_INLINE void free_slot_(size_t i, const this_type& ref) noexcept {
+        free_slot_(i, ref, std::integral_constant<bool, HRD_BACKWARD_SHIFT_ERASE && movable_slots_<this_type>::value>());
+    }
+
+    template <class this_type>
+    HRD_ALWAYS_INLINE void free_slot_(size_t i, const this_type&, std::false_type /*tombstone*/) noexcept
+    {
+        //set DELETED_MARK only if next element not 0
+        if (HRD_LIKELY(EMPTY_MARK == _elements[(i + 1) & _capacity]))
+            _elements[i] = EMPTY_MARK;
+        else {
+            _elements[i] = DELETED_MARK;
+            _erased++;
+        }
+    }
+
+    /** Backward shift: any following element of the cluster which probe sequence passes slot i moved there, repeated for its slot.
+     * Stops with DELETED_MARK at existing tombstone or end of mark array (elements never move across it, so iteration
+     * started before erase visits each element once).
+     */
     template <class this_type>
-    HRD_ALWAYS_INLINE size_type erase_(const typename this_type::key_type& k, this_type& ref) noexcept
+    HRD_ALWAYS_INLINE void free_slot_(size_t i, const this_type& ref, std::true_type /*shift*/) noexcept
     {
         auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
 
-        for (size_t i = ref(k);; ++i)
+        for (size_t j = (i + 1) & _capacity;; j = (j + 1) & _capacity)
         {
-            i &= _capacity;
-
-            auto h = _elements[i];
-            if (USED_MARK == h) {
-                auto& r = ee[i];
-                if (HRD_LIKELY(ref(this_type::key_getter::get_key(r.data), k))) //identical found
-                {
-                    using data_type = typename this_type::value_type;
-                    
-                    r.data.~data_type();
-                    _size--;
-
-                    h = _elements[(i + 1) & _capacity];
-                    //set DELETED_MARK only if next element not 0
-                    if (HRD_LIKELY(EMPTY_MARK == h))
-                        _elements[i] = EMPTY_MARK;
-                    else {
-                        _elements[i] = DELETED_MARK;
-                        _erased++;
+            const std::byte mark = _elements[j];
+            if (HRD_LIKELY(EMPTY_MARK == mark)) {
+                _elements[i] = EMPTY_MARK;
+                return;
+            }
+            if (HRD_UNLIKELY(DELETED_MARK == mark || !j)) {
+                _elements[i] = DELETED_MARK;
+                _erased++;
+                return;
+            }
+
+            size_t home = ref(this_type::key_getter::get_key(ee[j].data)) & _capacity;
+            if (((j - home) & _capacity) >= j - i) { //home not in (i, j]
+                move_slot_(ee + i, ee + j, typename this_type::IS_TRIVIALLY_COPYABLE());
+                _elements[i] = mark;
+                i = j;
+            }
+        }
+    }
+
+    template <typename storage_type>
+    HRD_ALWAYS_INLINE static void move_slot_(storage_type* dst, storage_type* src, std::true_type /*trivial data*/) noexcept {
+        memcpy((void*)dst, src, sizeof(storage_type));
+    }
+
+    template <typename storage_type>
+    HRD_ALWAYS_INLINE static void move_slot_(storage_type* dst, storage_type* src, std::false_type /*non-trivial data*/) noexcept {
+        using VT = decltype(src->data);
+        new ((void*)&dst->data) VT(std::move(src->data));
+        src->data.~VT();
+    }
+
+    template <typename storage_type, typename IS_TRIVIALLY_COPYABLE>
+    HRD_ALWAYS_INLINE static void swap_slots_(storage_type* a, storage_type* b, IS_TRIVIALLY_COPYABLE) noexcept {
+        alignas(storage_type) unsigned char tmp[sizeof(storage_type)];
+        move_slot_(reinterpret_cast<storage_type*>(tmp), a, IS_TRIVIALLY_COPYABLE());
+        move_slot_(a, b, IS_TRIVIALLY_COPYABLE());
+        move_slot_(b, reinterpret_cast<storage_type*>(tmp), IS_TRIVIALLY_COPYABLE());
+    }
+
+    /**
+     * Purge all DELETED_MARK inside current storage. Marks rewritten first: tombstones become EMPTY_MARK, elements - DELETED_MARK
+     * ("not placed yet"). Then every not placed element goes to the first not used slot of its probe chain: stays if it is own slot,
+     * moved to EMPTY_MARK one or swapped with other not placed element (which is processed next in the same slot).
+     * Slots before placed element in its chain are placed ones only, so chains never broken later.
+     */
+    template <class this_type>
+    void compact_(const this_type& ref) noexcept
+    {
+        auto* ee = data_<this_type>();
+        for (size_t i = 0; i <= _capacity; ++i)
+            _elements[i] = is_used(_elements[i]) ? DELETED_MARK : EMPTY_MARK;
+
+        const auto lanes = mark_group::lanes(_capacity);
+        for (size_t i = 0; i <= _capacity; ++i)
+        {
+            while (DELETED_MARK == _elements[i])
+            {
+                size_t h = ref(this_type::key_getter::get_key(ee[i].data));
+                size_t pos = h & _capacity;
+                auto skip = mark_group::from(pos);
+                for (pos = mark_group::base(pos);; pos = (pos + mark_group::WIDTH) & _capacity) {
+                    if (auto unused = mark_group(_elements + pos).unused() & lanes & skip) {
+                        pos += ctz(unused);
+                        break;
                     }
+                    skip = ~mark_group::mask_type(0);
+                }
 
-                    return 1;
+                if (pos != i) {
+                    if (EMPTY_MARK == _elements[pos]) {
+                        move_slot_(ee + pos, ee + i, typename this_type::IS_TRIVIALLY_COPYABLE());
+                        _elements[i] = EMPTY_MARK;
+                    }
+                    else
+                        swap_slots_(ee + pos, ee + i, typename this_type::IS_TRIVIALLY_COPYABLE());
                 }
+                _elements[pos] = make_mark(h);
             }
-            else if (EMPTY_MARK == h)
-                return 0;
         }
+        _erased = 0;
+    }
+
+    //no room for one more element: purge tombstones in place if they take quarter of load limit and more, double capacity otherwise
+    template <class this_type>
+    HRD_ALWAYS_INLINE void grow_(const this_type& ref)
+    {
+        if (movable_slots_<this_type>::value && _erased && _erased >= (_gap >> 2))
+            compact_(ref);
+        else
+            resize_pow2(2 * (_capacity + 1), ref);
+    }
+
+    template <class this_type>
+    void compact_impl(const this_type& ref)
+    {
+        if (!_erased)
+            return;
+        if (movable_slots_<this_type>::value)
+            compact_(ref);
+        else
+            resize_pow2(_capacity + 1, ref);
     }
 
     template <class this_type>
@@ -931,11 +1773,8 @@ protected:
         if (auto cnt = _size) {
             auto* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2<this_type>(_capacity));
             cnt--;
-            for (size_t i = 0;; ++i) {
-                auto* e = _elements + i;
-                if (HRD_UNLIKELY(*e == USED_MARK))
-                    return typename this_type::iterator(ee + i, e, cnt);
-            }
+            size_t i = next_used(_elements);
+            return typename this_type::iterator(ee + i, _elements + i, cnt);
         }
         return typename this_type::iterator();
     }
@@ -992,19 +1831,6 @@ protected:
         if (!r._capacity)
             r._elements = reinterpret_cast<std::byte*>(&r._size);
     }
-#ifdef _MSC_VER
-    HRD_ALWAYS_INLINE static uint64_t umul128(uint64_t a, uint64_t b) noexcept {
-        uint64_t h, l = _umul128(a, b, &h);
-        return l + h;
-    }
-#else
-    HRD_ALWAYS_INLINE static uint64_t umul128(uint64_t a, uint64_t b) noexcept {
-        using uint128_t = unsigned __int128;
-
-        auto result = static_cast<uint128_t>(a) * static_cast<uint128_t>(b);
-        return static_cast<uint64_t>(result) + static_cast<uint64_t>(result >> 64U);
-    }
-#endif
 
     size_type  _size;
     size_type  _capacity;
@@ -1013,6 +1839,7 @@ protected:
 	std::byte* _elements;
 };
 
+#if HRD_FNV_HASH
 template<>
 HRD_ALWAYS_INLINE size_t hash_base::hash_1<1>(const void* ptr) noexcept {
     return (0xcbf29ce484222325ULL ^ (*(uint8_t*)ptr)) * 0x100000001b3ULL;
@@ -1070,11 +1897,48 @@ HRD_ALWAYS_INLINE size_t hash_base::hash_1<16>(const void* ptr) noexcept
 }
 
 template<>
-struct hash_base::hash_<std::string> {
-    HRD_ALWAYS_INLINE size_t operator()(const std::string& val) const noexcept {
-        return hash_base::fnv_1a(val.c_str(), val.size());
+struct hash_base::hash_<std::string_view> {
+    using is_transparent = void;
+
+    HRD_ALWAYS_INLINE size_t operator()(std::string_view val) const noexcept {
+        return hash_base::fnv_1a(val.data(), val.size());
+    }
+};
+#else
+//integers: single folded 128-bit multiply (mum-style), keys of other sizes go to hash_bytes
+template<>
+HRD_ALWAYS_INLINE size_t hash_base::hash_1<1>(const void* ptr) noexcept {
+    return umul128(*(uint8_t*)ptr ^ HASH_SEED, 0xde5fb9d2630458e9ull);
+}
+
+template<>
+HRD_ALWAYS_INLINE size_t hash_base::hash_1<2>(const void* ptr) noexcept {
+    return umul128(*(uint16_t*)ptr ^ HASH_SEED, 0xde5fb9d2630458e9ull);
+}
+
+template<>
+HRD_ALWAYS_INLINE size_t hash_base::hash_1<4>(const void* ptr) noexcept {
+    return umul128(*(uint32_t*)ptr ^ HASH_SEED, 0xde5fb9d2630458e9ull);
+}
+
+template<>
+HRD_ALWAYS_INLINE size_t hash_base::hash_1<8>(const void* ptr) noexcept {
+    return umul128(*(uint64_t*)ptr ^ HASH_SEED, 0xde5fb9d2630458e9ull);
+}
+
+template<>
+struct hash_base::hash_<std::string_view> {
+    using is_transparent = void;
+
+    HRD_ALWAYS_INLINE size_t operator()(std::string_view val) const noexcept {
+        return hash_base::hash_bytes(val.data(), val.size());
     }
 };
+#endif //HRD_FNV_HASH
+
+//std::string, std::string_view and const char* of the same text hash equally: with std::equal_to<> std::string table is searched by any of them
+template<>
+struct hash_base::hash_<std::string> : public hash_base::hash_<std::string_view> {};
 
 // Helper to check if a type is trivially copyable and has no padding
 template <typename T>
@@ -1197,11 +2061,12 @@ struct hash_base::hash_<std::tuple<T1, T2, T3>> : public hash_tuple_impl<T1, T2,
 
 //----------------------------------------- hash_set -----------------------------------------
 
-template<class Key, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>>
-class hash_set : public hash_base, public hash_base::hash_eql<Hash, Pred>
+template<class Key, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>, class Alloc = malloc_allocator>
+class hash_set : public hash_base, public hash_base::hash_eql<Hash, Pred>, private Alloc
 {
 public:
-    using this_type       = hash_set<Key, Hash, Pred>;
+    using this_type       = hash_set<Key, Hash, Pred, Alloc>;
+    using allocator_type  = Alloc;
     using key_type        = Key;
     using hasher_type     = Hash;
     using keyeql_type     = Pred;
@@ -1232,28 +2097,42 @@ public:
     using iterator       = typename iterator_base<this_type>::iterator;
     using const_iterator = typename iterator_base<this_type>::const_iterator;
 
+    //key type of lookups, see hash_base::lookup_key
+    template<class K>
+    using key_arg = typename lookup_key<Hash, Pred>::template type<K, key_type>;
+
     hash_set() {
         ctor_empty();
     }
 
-    hash_set(const hash_set& r) : hash_pred(r) {
+    hash_set(const hash_set& r) : hash_pred(r), Alloc(r.get_allocator()) {
         ctor_copy(IS_TRIVIALLY_COPYABLE(), r);
     }
 
-    hash_set(hash_set&& r) noexcept : hash_pred(std::move(r)) {
+    hash_set(hash_set&& r) noexcept : hash_pred(std::move(r)), Alloc(std::move(static_cast<Alloc&>(r))) {
         ctor_move(std::move(r));
     }
 
-    hash_set(size_type hint_size, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : hash_pred(hf, eql) {
-        ctor_pow2<this_type>(calc_pow2(hint_size), sizeof(storage_type));
+    explicit hash_set(const allocator_type& alloc) : Alloc(alloc) {
+        ctor_empty();
+    }
+
+    hash_set(size_type hint_size, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
+        ctor_pow2<this_type>(calc_pow2(hint_size));
     }
 
     template<typename Iter>
-    hash_set(Iter first, Iter last, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : hash_pred(hf, eql) {
+    hash_set(Iter first, Iter last, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
         ctor_iters(first, last, *this, typename std::iterator_traits<Iter>::iterator_category());
     }
 
-    hash_set(std::initializer_list<value_type> lst, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : hash_pred(hf, eql) {
+    hash_set(std::initializer_list<value_type> lst, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
         ctor_init_list(lst, *this);
     }
 
@@ -1301,6 +2180,11 @@ public:
     void swap(hash_set& r) noexcept {
         hash_base::swap(r);
         hash_pred::swap(r);
+        std::swap(static_cast<Alloc&>(*this), static_cast<Alloc&>(r));
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return static_cast<const Alloc&>(*this);
     }
 
     /*! Can invalidate iterators. */
@@ -1331,22 +2215,81 @@ public:
         return insert_(std::forward<K>(val), const_cast<this_type&>(*this), std::false_type(), std::true_type());
     }
 
-    iterator find(const key_type& k) noexcept {
+    /*! Can invalidate iterators.
+    * \params hash - hash of val computed before by hasher(), insert/find/erase of the same key in several tables hash it once
+    */
+    std::pair<iterator, bool> insert(const key_type& val, size_t hash) {
+        return insert_(val, hash, *this, std::false_type(), std::true_type());
+    }
+
+    std::pair<iterator, bool> insert(key_type&& val, size_t hash) {
+        return insert_(std::move(val), hash, *this, std::false_type(), std::true_type());
+    }
+
+    template<class K = key_type>
+    iterator find(const key_arg<K>& k) noexcept {
         return find_iter_(k, *this, std::true_type());
     }
 
-    const_iterator find(const key_type& k) const noexcept {
+    template<class K = key_type>
+    const_iterator find(const key_arg<K>& k) const noexcept {
         return find_iter_(k, *this, std::true_type());
     }
 
-    size_type count(const key_type& k) const noexcept {
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k) const noexcept {
         return find_(k, *this, std::true_type()) != nullptr;
     }
 
-	bool contains(const key_type& k) const noexcept {
+	template<class K = key_type>
+	bool contains(const key_arg<K>& k) const noexcept {
 		return find_(k, *this, std::true_type()) != nullptr;
 	}
 
+    //lookups by hash of k computed before, see insert(val, hash)
+    template<class K = key_type>
+    iterator find(const key_arg<K>& k, size_t hash) noexcept {
+        return find_iter_(k, hash, *this, std::true_type());
+    }
+
+    template<class K = key_type>
+    const_iterator find(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_iter_(k, hash, *this, std::true_type());
+    }
+
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash, *this, std::true_type()) != nullptr;
+    }
+
+    template<class K = key_type>
+    bool contains(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash, *this, std::true_type()) != nullptr;
+    }
+
+    /*! Lookup of keys [first, last) by batches: keys hashed and their slots prefetched before probing.
+    * \params out - receives find() result for every key in order (Iter must be multi-pass)
+    * \return out past the last written result
+    */
+    template<typename Iter, typename Out>
+    Out find_many(Iter first, Iter last, Out out) {
+        return find_many_<iterator>(first, last, out, *this);
+    }
+
+    template<typename Iter, typename Out>
+    Out find_many(Iter first, Iter last, Out out) const {
+        return find_many_<const_iterator>(first, last, out, *this);
+    }
+
+    /*! Batched contains(), see find_many().
+    * \params out - receives bool for every key in order
+    * \return number of found keys
+    */
+    template<typename Iter, typename Out>
+    size_type contains_many(Iter first, Iter last, Out out) const {
+        return contains_many_(first, last, out, *this);
+    }
+
     /*! Can invalidate iterators.
     * \params it - Iterator pointing to a single element to be removed
     * \return an iterator pointing to the position immediately following of the element erased
@@ -1355,18 +2298,36 @@ public:
         return erase_<this_type>(it);
     }
 
+    //exact match for iterator argument, erase(key_arg<K>) of transparent table takes it otherwise
+    iterator erase(iterator it) noexcept {
+        return erase(const_iterator(it));
+    }
+
     /*! Can invalidate iterators.
     * \params k - Key of the element to be erased
     * \return 1 - if element erased and zero otherwise
     */
-    size_type erase(const key_type& k) noexcept {
+    template<class K = key_type>
+    size_type erase(const key_arg<K>& k) noexcept {
         return erase_(k, *this);
     }
 
+    template<class K = key_type>
+    size_type erase(const key_arg<K>& k, size_t hash) noexcept {
+        return erase_(k, hash, *this);
+    }
+
     void shrink_to_fit() {
         hash_base::shrink_to_fit_impl<this_type>(*this);
     }
 
+    /*! Purge erased slots keeping capacity, can invalidate iterators.
+    * In place (no allocation) if elements are nothrow movable, rehash to new storage otherwise.
+    */
+    void compact() {
+        hash_base::compact_impl<this_type>(*this);
+    }
+
     hash_set& operator=(const hash_set& r) {
         this_type(r).swap(*this);
         return *this;
@@ -1393,8 +2354,8 @@ public:
 	}
 
 private:
-    hash_set(size_type pow2, bool) {
-        ctor_pow2<this_type>(pow2, sizeof(storage_type));
+    hash_set(size_type pow2, bool, const allocator_type& alloc) : Alloc(alloc) {
+        ctor_pow2<this_type>(pow2);
     }
 };
 
@@ -1404,11 +2365,12 @@ private:
 
 //----------------------------------------- hash_grow_set -----------------------------------------
 
-template<class Key, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>>
-class hash_grow_set : public hash_base, public hash_base::hash_eql<Hash, Pred>
+template<class Key, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>, class Alloc = malloc_allocator>
+class hash_grow_set : public hash_base, public hash_base::hash_eql<Hash, Pred>, private Alloc
 {
 public:
-    using this_type       = hash_grow_set<Key, Hash, Pred>;
+    using this_type       = hash_grow_set<Key, Hash, Pred, Alloc>;
+    using allocator_type  = Alloc;
     using key_type        = Key;
     using hasher_type     = Hash;
     using keyeql_type     = Pred;
@@ -1439,28 +2401,42 @@ public:
     using iterator       = typename iterator_base<this_type>::iterator;
     using const_iterator = typename iterator_base<this_type>::const_iterator;
 
+    //key type of lookups, see hash_base::lookup_key
+    template<class K>
+    using key_arg = typename lookup_key<Hash, Pred>::template type<K, key_type>;
+
     hash_grow_set() {
         ctor_empty();
     }
 
-    hash_grow_set(const hash_grow_set& r) : hash_pred(r) {
+    hash_grow_set(const hash_grow_set& r) : hash_pred(r), Alloc(r.get_allocator()) {
         ctor_copy(IS_TRIVIALLY_COPYABLE(), r);
     }
 
-    hash_grow_set(hash_grow_set&& r) noexcept : hash_pred(std::move(r)) {
+    hash_grow_set(hash_grow_set&& r) noexcept : hash_pred(std::move(r)), Alloc(std::move(static_cast<Alloc&>(r))) {
         ctor_move(std::move(r));
     }
 
-    hash_grow_set(size_type hint_size, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : hash_pred(hf, eql) {
-        ctor_pow2<this_type>(calc_pow2(hint_size), sizeof(storage_type));
+    explicit hash_grow_set(const allocator_type& alloc) : Alloc(alloc) {
+        ctor_empty();
+    }
+
+    hash_grow_set(size_type hint_size, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
+        ctor_pow2<this_type>(calc_pow2(hint_size));
     }
 
     template<typename Iter>
-    hash_grow_set(Iter first, Iter last, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : hash_pred(hf, eql) {
+    hash_grow_set(Iter first, Iter last, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
         ctor_iters(first, last, *this, typename std::iterator_traits<Iter>::iterator_category());
     }
 
-    hash_grow_set(std::initializer_list<value_type> lst, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : hash_pred(hf, eql) {
+    hash_grow_set(std::initializer_list<value_type> lst, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
         ctor_init_list(lst, *this);
     }
 
@@ -1508,9 +2484,14 @@ public:
     void swap(hash_grow_set& r) noexcept {
         hash_base::swap(r);
         hash_pred::swap(r);
+        std::swap(static_cast<Alloc&>(*this), static_cast<Alloc&>(r));
     }
 
-    /*! Can invalidate iterators. */
+    allocator_type get_allocator() const noexcept {
+        return static_cast<const Alloc&>(*this);
+    }
+
+    /*! Can invalidate iterators. */
     std::pair<iterator, bool> insert(const key_type& val) {
         return insert_(val, const_cast<this_type&>(*this), std::false_type(), std::false_type());
     }
@@ -1538,6 +2519,17 @@ public:
         return insert_(std::forward<K>(val), const_cast<this_type&>(*this), std::false_type(), std::false_type());
     }
 
+    /*! Can invalidate iterators.
+    * \params hash - hash of val computed before by hasher(), insert/find of the same key in several tables hash it once
+    */
+    std::pair<iterator, bool> insert(const key_type& val, size_t hash) {
+        return insert_(val, hash, *this, std::false_type(), std::false_type());
+    }
+
+    std::pair<iterator, bool> insert(key_type&& val, size_t hash) {
+        return insert_(std::move(val), hash, *this, std::false_type(), std::false_type());
+    }
+
     template<class k_type>
     iterator find(const k_type& k) noexcept {
         return find_iter_(k, *this, std::false_type());
@@ -1548,14 +2540,60 @@ public:
         return find_iter_(k, *this, std::false_type());
     }
 
-    size_type count(const key_type& k) const noexcept {
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k) const noexcept {
         return find_(k, *this, std::false_type()) != nullptr;
     }
 
-	bool contains(const key_type& k) const noexcept {
+	template<class K = key_type>
+	bool contains(const key_arg<K>& k) const noexcept {
 		return find_(k, *this, std::false_type()) != nullptr;
 	}
 
+    //lookups by hash of k computed before, see insert(val, hash)
+    template<class k_type>
+    iterator find(const k_type& k, size_t hash) noexcept {
+        return find_iter_(k, hash, *this, std::false_type());
+    }
+
+    template<class k_type>
+    const_iterator find(const k_type& k, size_t hash) const noexcept {
+        return find_iter_(k, hash, *this, std::false_type());
+    }
+
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash, *this, std::false_type()) != nullptr;
+    }
+
+    template<class K = key_type>
+    bool contains(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash, *this, std::false_type()) != nullptr;
+    }
+
+    /*! Lookup of keys [first, last) by batches: keys hashed and their slots prefetched before probing.
+    * \params out - receives find() result for every key in order (Iter must be multi-pass)
+    * \return out past the last written result
+    */
+    template<typename Iter, typename Out>
+    Out find_many(Iter first, Iter last, Out out) {
+        return find_many_<iterator>(first, last, out, *this);
+    }
+
+    template<typename Iter, typename Out>
+    Out find_many(Iter first, Iter last, Out out) const {
+        return find_many_<const_iterator>(first, last, out, *this);
+    }
+
+    /*! Batched contains(), see find_many().
+    * \params out - receives bool for every key in order
+    * \return number of found keys
+    */
+    template<typename Iter, typename Out>
+    size_type contains_many(Iter first, Iter last, Out out) const {
+        return contains_many_(first, last, out, *this);
+    }
+
     void shrink_to_fit() {
         hash_base::shrink_to_fit_impl<this_type>(*this);
     }
@@ -1586,8 +2624,8 @@ public:
 	}
 
 private:
-    hash_grow_set(size_type pow2, bool) {
-        ctor_pow2<this_type>(pow2, sizeof(storage_type));
+    hash_grow_set(size_type pow2, bool, const allocator_type& alloc) : Alloc(alloc) {
+        ctor_pow2<this_type>(pow2);
     }
 };
 
@@ -1597,11 +2635,12 @@ private:
 
 //----------------------------------------- hash_map -----------------------------------------
 
-template<class Key, class T, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>>
-class hash_map : public hash_base, public hash_base::hash_eql<Hash, Pred>
+template<class Key, class T, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>, class Alloc = malloc_allocator>
+class hash_map : public hash_base, public hash_base::hash_eql<Hash, Pred>, private Alloc
 {
 public:
-    using this_type       = hash_map<Key, T, Hash, Pred>;
+    using this_type       = hash_map<Key, T, Hash, Pred, Alloc>;
+    using allocator_type  = Alloc;
     using key_type        = Key;
     using mapped_type     = T;
     using hasher_type     = Hash;
@@ -1613,6 +2652,7 @@ public:
 private:
     friend iterator_base<this_type>;
     friend hash_base;
+    template<class K, class V, class H, class P, size_t SHARDS> friend class concurrent_hash_map; //emplace_hashed_ by shard hash
     using storage_type = StorageItem<value_type>;
     using hash_pred    = hash_eql<Hash, Pred>;
 
@@ -1633,28 +2673,42 @@ public:
     using iterator       = typename iterator_base<this_type>::iterator;
     using const_iterator = typename iterator_base<this_type>::const_iterator;
 
+    //key type of lookups, see hash_base::lookup_key
+    template<class K>
+    using key_arg = typename lookup_key<Hash, Pred>::template type<K, key_type>;
+
     hash_map() {
         ctor_empty();
     }
 
-    hash_map(const hash_map& r) : hash_pred(r) {
+    hash_map(const hash_map& r) : hash_pred(r), Alloc(r.get_allocator()) {
         ctor_copy(IS_TRIVIALLY_COPYABLE(), r);
     }
 
-    hash_map(hash_map&& r) noexcept : hash_pred(std::move(r)) {
+    hash_map(hash_map&& r) noexcept : hash_pred(std::move(r)), Alloc(std::move(static_cast<Alloc&>(r))) {
         ctor_move(std::move(r));
     }
 
-    hash_map(size_type hint_size, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : hash_pred(hf, eql) {
-        ctor_pow2<this_type>(calc_pow2(hint_size), sizeof(storage_type));
+    explicit hash_map(const allocator_type& alloc) : Alloc(alloc) {
+        ctor_empty();
+    }
+
+    hash_map(size_type hint_size, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
+        ctor_pow2<this_type>(calc_pow2(hint_size));
     }
 
     template<typename Iter>
-    hash_map(Iter first, Iter last, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : hash_pred(hf, eql) {
+    hash_map(Iter first, Iter last, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
         ctor_iters(first, last, *this, typename std::iterator_traits<Iter>::iterator_category());
     }
 
-    hash_map(std::initializer_list<value_type> lst, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : hash_pred(hf, eql) {
+    hash_map(std::initializer_list<value_type> lst, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
         ctor_init_list(lst, *this);
     }
 
@@ -1702,6 +2756,11 @@ public:
     void swap(hash_map& r) noexcept {
         hash_base::swap(r);
         hash_pred::swap(r);
+        std::swap(static_cast<Alloc&>(*this), static_cast<Alloc&>(r));
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return static_cast<const Alloc&>(*this);
     }
 
     std::pair<iterator, bool> insert(const value_type& val) {
@@ -1733,35 +2792,128 @@ public:
         return emplace_(std::forward<K>(key), std::forward<Args>(args)...);
     }
 
-    iterator find(const key_type& k) noexcept {
+    /*! Can invalidate iterators. Probes first: mapped value constructed from args only if k is absent, args untouched otherwise.
+    * \return iterator to the element with key k and true if inserted
+    */
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+        return emplace_(k, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+        return emplace_(std::move(k), std::forward<Args>(args)...);
+    }
+
+    /*! Can invalidate iterators. obj assigned to mapped value of present k, inserted with k (constructed from obj) otherwise.
+    * \return iterator to the element with key k and true if inserted
+    */
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+        auto ret = emplace_(k, std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+        auto ret = emplace_(std::move(k), std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+
+    /*! Can invalidate iterators.
+    * \params hash - hash of val.first computed before by hasher(), operations on the same key in several tables hash it once
+    */
+    std::pair<iterator, bool> insert(const value_type& val, size_t hash) {
+        return insert_(val, hash, *this, std::false_type(), std::true_type());
+    }
+
+    std::pair<iterator, bool> insert(value_type&& val, size_t hash) {
+        return insert_(std::move(val), hash, *this, std::false_type(), std::true_type());
+    }
+
+    template<class K = key_type>
+    iterator find(const key_arg<K>& k) noexcept {
         return find_iter_(k, *this, std::true_type());
     }
 
-    const_iterator find(const key_type& k) const noexcept {
+    template<class K = key_type>
+    const_iterator find(const key_arg<K>& k) const noexcept {
         return find_iter_(k, *this, std::true_type());
     }
 
-    mapped_type& at(const key_type& k) {
+    template<class K = key_type>
+    mapped_type& at(const key_arg<K>& k) {
         if (auto* p = find_(k, *this, std::true_type()))
             return p->data.second;
         throw_out_of_range();
     }
 
-	const mapped_type& at(const key_type& k) const {
+	template<class K = key_type>
+	const mapped_type& at(const key_arg<K>& k) const {
 		if (auto* p = find_(k, *this, std::true_type()))
 			return p->data.second;
 		throw_out_of_range();
 	}
 
-    size_type count(const key_type& k) const noexcept {
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k) const noexcept {
         return find_(k, *this, std::true_type()) != nullptr;
     }
 
-    bool contains(const key_type& k) const noexcept {
+    template<class K = key_type>
+    bool contains(const key_arg<K>& k) const noexcept {
 		return find_(k, *this, std::true_type()) != nullptr;
 	}
 
-    /*! Doesn't invalidate iterators.
+    //lookups by hash of k computed before, see insert(val, hash)
+    template<class K = key_type>
+    iterator find(const key_arg<K>& k, size_t hash) noexcept {
+        return find_iter_(k, hash, *this, std::true_type());
+    }
+
+    template<class K = key_type>
+    const_iterator find(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_iter_(k, hash, *this, std::true_type());
+    }
+
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash, *this, std::true_type()) != nullptr;
+    }
+
+    template<class K = key_type>
+    bool contains(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash, *this, std::true_type()) != nullptr;
+    }
+
+    /*! Lookup of keys [first, last) by batches: keys hashed and their slots prefetched before probing.
+    * \params out - receives find() result for every key in order (Iter must be multi-pass)
+    * \return out past the last written result
+    */
+    template<typename Iter, typename Out>
+    Out find_many(Iter first, Iter last, Out out) {
+        return find_many_<iterator>(first, last, out, *this);
+    }
+
+    template<typename Iter, typename Out>
+    Out find_many(Iter first, Iter last, Out out) const {
+        return find_many_<const_iterator>(first, last, out, *this);
+    }
+
+    /*! Batched contains(), see find_many().
+    * \params out - receives bool for every key in order
+    * \return number of found keys
+    */
+    template<typename Iter, typename Out>
+    size_type contains_many(Iter first, Iter last, Out out) const {
+        return contains_many_(first, last, out, *this);
+    }
+
+    /*! Can invalidate iterators.
     * \params it - Iterator pointing to a single element to be removed
     * \return return an iterator pointing to the position immediately following of the element erased
     */
@@ -1769,18 +2921,36 @@ public:
         return erase_<this_type>(it);
     }
 
-    /*! Doesn't invalidate iterators.
+    //exact match for iterator argument, erase(key_arg<K>) of transparent table takes it otherwise
+    iterator erase(iterator it) noexcept {
+        return erase(const_iterator(it));
+    }
+
+    /*! Can invalidate iterators.
     * \params k - Key of the element to be erased
     * \return 1 - if element erased and zero otherwise
     */
-    size_type erase(const key_type& k) noexcept {
+    template<class K = key_type>
+    size_type erase(const key_arg<K>& k) noexcept {
         return erase_(k, *this);
     }
 
+    template<class K = key_type>
+    size_type erase(const key_arg<K>& k, size_t hash) noexcept {
+        return erase_(k, hash, *this);
+    }
+
     void shrink_to_fit() {
         hash_base::shrink_to_fit_impl<this_type>(*this);
     }
 
+    /*! Purge erased slots keeping capacity, can invalidate iterators.
+    * In place (no allocation) if elements are nothrow movable, rehash to new storage otherwise.
+    */
+    void compact() {
+        hash_base::compact_impl<this_type>(*this);
+    }
+
     hash_map& operator=(const hash_map& r) {
         this_type(r).swap(*this);
         return *this;
@@ -1792,11 +2962,20 @@ public:
     }
 
     mapped_type& operator[](const key_type& k) {
-        return find_insert(k);
+        return find_insert_(k, (*this)(k));
     }
 
     mapped_type& operator[](key_type&& k) {
-        return find_insert(std::move(k));
+        return find_insert_(std::move(k), (*this)(k));
+    }
+
+    //operator[] by hash of k computed before, see insert(val, hash)
+    mapped_type& find_insert(const key_type& k, size_t hash) {
+        return find_insert_(k, hash);
+    }
+
+    mapped_type& find_insert(key_type&& k, size_t hash) {
+        return find_insert_(std::move(k), hash);
     }
 
 	// Index of an element. Actual only if no reallocation happens after
@@ -1815,107 +2994,636 @@ public:
 	}
 
 private:
-    hash_map(size_type pow2, bool) {
-        ctor_pow2<this_type>(pow2, sizeof(storage_type));
+    hash_map(size_type pow2, bool, const allocator_type& alloc) : Alloc(alloc) {
+        ctor_pow2<this_type>(pow2);
     }
 
     template<typename K, typename... Args>
-    HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace_(K&& k, Args&&... args)
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace_(K&& k, Args&&... args) {
+        return emplace_hashed_((*this)(k), std::forward<K>(k), std::forward<Args>(args)...);
+    }
+
+    //h - hash of k
+    template<typename K, typename... Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace_hashed_(size_t h, K&& k, Args&&... args)
     {
         size_t used = _erased + _size;
         if (HRD_UNLIKELY(used >= _gap))
-            resize_pow2(2 * (_capacity + 1), *this);
+            grow_(*this);
 
-        size_t empty_spot = SIZE_MAX;
-        uint32_t deleted_mark = DELETED_MARK;
         auto* ee = reinterpret_cast<storage_type*>(_elements + align_ppow2<this_type>(_capacity));
 
-        for (size_t i = hash_pred::operator()(k);; ++i)
-        {
-            i &= _capacity;
-            auto* r = ee + i;
-            int32_t h = _elements[i];
-            if (!h)
-            {
-                if (HRD_UNLIKELY(empty_spot != SIZE_MAX)) {
-                    r = ee + empty_spot;
-                    i = empty_spot;
-                }
+        auto pos = insert_pos_(k, h, *this, std::true_type());
+        auto* r = ee + pos.first;
+        if (pos.second) //identical found
+            return std::pair<iterator, bool>(iterator(r, _elements + pos.first), false);
 
-                std::pair<iterator, bool> ret(iterator(r, _elements + i), true);
-                new ((void*)&r->data) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(k)), std::forward_as_tuple(std::forward<Args>(args)...));
-                _elements[i] = USED_MARK;
-                _size++;
-                if (HRD_UNLIKELY(empty_spot != SIZE_MAX)) _erased--;
-                return ret;
-            }
-            if (h == USED_MARK)
-            {
-                if (HRD_LIKELY(hash_pred::operator()(r->data.first, k))) //identical found
-                    return std::pair<iterator, bool>(iterator(r, _elements + i), false);
-            }
-            else if (h == deleted_mark)
-            {
-                deleted_mark = 0; //use first found empty spot
-                empty_spot = i;
-            }
-        }
+        new ((void*)&r->data) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(k)), std::forward_as_tuple(std::forward<Args>(args)...));
+        if (HRD_UNLIKELY(DELETED_MARK == _elements[pos.first])) _erased--;
+        _elements[pos.first] = make_mark(h);
+        _size++;
+        return std::pair<iterator, bool>(iterator(r, _elements + pos.first), true);
     }
 
     template<typename V>
-    HRD_ALWAYS_INLINE mapped_type& find_insert(V&& k)
+    HRD_ALWAYS_INLINE mapped_type& find_insert_(V&& k, size_t h)
     {
         size_type used = _erased + _size;
         if (HRD_UNLIKELY(used >= _gap))
-            resize_pow2(2 * (_capacity + 1), *this);
+            grow_(*this);
 
-        size_t empty_spot = SIZE_MAX;
-        auto match_mark = DELETED_MARK;
         auto* ee = reinterpret_cast<storage_type*>(_elements + align_ppow2<this_type>(_capacity));
 
-        for (size_t i = hash_pred::operator()(k);; ++i)
+        auto pos = insert_pos_(k, h, *this, std::true_type());
+        auto* r = ee + pos.first;
+        if (pos.second) //identical found
+            return r->data.second;
+
+        new ((void*)&r->data) value_type(std::forward<V>(k), mapped_type());
+        if (HRD_UNLIKELY(DELETED_MARK == _elements[pos.first])) _erased--;
+        _elements[pos.first] = make_mark(h);
+        _size++;
+        return r->data.second;
+    }
+};
+
+#pragma endregion hash_map
+
+#pragma region hash_map_rh
+
+//----------------------------------------- hash_map_rh -----------------------------------------
+
+/**
+ * Robin Hood sibling of hash_map: mark byte keeps probe distance of the element (USED_MARK | distance, 127 means "127 and more",
+ * actual one recalculated by hash then). Elements of a cluster ordered by home slot: insert shifts the rest of the cluster
+ * forward to put new element before all farther from home ones, erase shifts it back (no DELETED_MARK).
+ * Lookup stops at first slot whose element is closer to its home than probed key would be, so misses are as short as hits.
+ * Elements relocated on insert/erase: key and mapped types must be nothrow move constructible (or trivially copyable).
+ */
+template<class Key, class T, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>, class Alloc = malloc_allocator>
+class hash_map_rh : public hash_base, public hash_base::hash_eql<Hash, Pred>, private Alloc
+{
+public:
+    using this_type       = hash_map_rh<Key, T, Hash, Pred, Alloc>;
+    using allocator_type  = Alloc;
+    using key_type        = Key;
+    using mapped_type     = T;
+    using hasher_type     = Hash;
+    using keyeql_type     = Pred;
+    using value_type      = std::pair<const key_type, mapped_type>;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+
+private:
+    friend iterator_base<this_type>;
+    friend hash_base;
+    template<class table_type> friend struct hash_stream; //places decoded elements by emplace_hashed_
+    using storage_type = StorageItem<value_type>;
+    using hash_pred    = hash_eql<Hash, Pred>;
+
+    using IS_TRIVIALLY_COPYABLE     = std::integral_constant<bool, std::is_trivially_copyable<key_type>::value && std::is_trivially_copyable<mapped_type>::value>;
+    using IS_TRIVIALLY_DESTRUCTIBLE = std::integral_constant<bool, std::is_trivially_destructible<key_type>::value && std::is_trivially_destructible<mapped_type>::value>;
+    using IS_NOTHROW_CONSTRUCTIBLE  = std::integral_constant<bool, std::is_nothrow_constructible<key_type>::value && std::is_nothrow_constructible<mapped_type>::value>;
+
+    static_assert(IS_TRIVIALLY_COPYABLE::value || (std::is_nothrow_move_constructible<key_type>::value && std::is_nothrow_move_constructible<mapped_type>::value),
+        "hash_map_rh relocates elements: key and mapped types must be nothrow move constructible");
+
+    struct key_getter {
+        HRD_ALWAYS_INLINE static const key_type& get_key(const value_type& r) noexcept {
+            return r.first;
+        }
+        HRD_ALWAYS_INLINE static const key_type& get_key(const storage_type& r) noexcept {
+            return r.data.first;
+        }
+    };
+
+    //stored distance of farther elements
+    constexpr static uint8_t DIST_SATURATED = 0x7F;
+
+public:
+    using iterator       = typename iterator_base<this_type>::iterator;
+    using const_iterator = typename iterator_base<this_type>::const_iterator;
+
+    //key type of lookups, see hash_base::lookup_key
+    template<class K>
+    using key_arg = typename lookup_key<Hash, Pred>::template type<K, key_type>;
+
+    hash_map_rh() {
+        ctor_empty();
+    }
+
+    hash_map_rh(const hash_map_rh& r) : hash_pred(r), Alloc(r.get_allocator()) {
+        ctor_copy_rh_(IS_TRIVIALLY_COPYABLE(), r);
+    }
+
+    hash_map_rh(hash_map_rh&& r) noexcept : hash_pred(std::move(r)), Alloc(std::move(static_cast<Alloc&>(r))) {
+        ctor_move(std::move(r));
+    }
+
+    explicit hash_map_rh(const allocator_type& alloc) : Alloc(alloc) {
+        ctor_empty();
+    }
+
+    hash_map_rh(size_type hint_size, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
+        ctor_pow2<this_type>(calc_pow2(hint_size));
+    }
+
+    template<typename Iter>
+    hash_map_rh(Iter first, Iter last, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
+        ctor_empty();
+        dtor_if_throw_constructible<this_type> tmp(*this);
+        insert(first, last);
+        tmp.reset();
+    }
+
+    hash_map_rh(std::initializer_list<value_type> lst, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_map_rh(lst.begin(), lst.end(), hf, eql, alloc)
+    {}
+
+    ~hash_map_rh() {
+        hash_base::dtor(IS_TRIVIALLY_DESTRUCTIBLE(), this);
+    }
+
+    static constexpr size_type max_size() noexcept {
+        return (size_type(1) << (sizeof(size_type) * 8 - 1)) / sizeof(storage_type);
+    }
+
+    iterator begin() noexcept {
+        return begin_<this_type>();
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_cast<this_type*>(this)->begin();
+    }
+
+    iterator end() noexcept {
+        return iterator();
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator();
+    }
+
+    void reserve(size_type hint) {
+        auto pow2 = calc_pow2(hint);
+        if (HRD_LIKELY(pow2 > (_capacity + 1)))
+            resize_rh_(pow2);
+    }
+
+    void clear(bool shrink = false) noexcept {
+        hash_base::clear<this_type>(IS_TRIVIALLY_DESTRUCTIBLE());
+        if (shrink) shrink_to_fit();
+    }
+
+    void swap(hash_map_rh& r) noexcept {
+        hash_base::swap(r);
+        hash_pred::swap(r);
+        std::swap(static_cast<Alloc&>(*this), static_cast<Alloc&>(r));
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return static_cast<const Alloc&>(*this);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& val) {
+        return emplace_(val.first, val.second);
+    }
+
+    template <class P>
+    std::pair<iterator, bool> insert(P&& val) {
+        return emplace_(std::forward<P>(val).first, std::forward<P>(val).second);
+    }
+
+    template<typename Iter>
+    void insert(Iter first, Iter last) {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+
+    void insert(std::initializer_list<value_type> lst) {
+        insert(lst.begin(), lst.end());
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> emplace(const Key& key, Args&&... args) {
+        return emplace_(key, std::forward<Args>(args)...);
+    }
+
+    template<class K, class... Args>
+    std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
+        return emplace_(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
+    /*! Can invalidate iterators. Probes first: mapped value constructed from args only if k is absent, args untouched otherwise.
+    * \return iterator to the element with key k and true if inserted
+    */
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+        return emplace_(k, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+        return emplace_(std::move(k), std::forward<Args>(args)...);
+    }
+
+    /*! Can invalidate iterators. obj assigned to mapped value of present k, inserted with k (constructed from obj) otherwise.
+    * \return iterator to the element with key k and true if inserted
+    */
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+        auto ret = emplace_(k, std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+        auto ret = emplace_(std::move(k), std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+
+    /*! Can invalidate iterators.
+    * \params hash - hash of val.first computed before by hasher(), operations on the same key in several tables hash it once
+    */
+    std::pair<iterator, bool> insert(const value_type& val, size_t hash) {
+        return emplace_hashed_(hash, val.first, val.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& val, size_t hash) {
+        return emplace_hashed_(hash, std::move(val).first, std::move(val).second);
+    }
+
+    template<class K = key_type>
+    iterator find(const key_arg<K>& k) noexcept {
+        size_t i = find_pos_rh_(k, (*this)(k));
+        return (i != SIZE_MAX) ? iterator(data_<this_type>() + i, _elements + i, 0) : iterator();
+    }
+
+    template<class K = key_type>
+    const_iterator find(const key_arg<K>& k) const noexcept {
+        return const_cast<this_type*>(this)->find(k);
+    }
+
+    template<class K = key_type>
+    mapped_type& at(const key_arg<K>& k) {
+        size_t i = find_pos_rh_(k, (*this)(k));
+        if (i != SIZE_MAX)
+            return data_<this_type>()[i].data.second;
+        throw_out_of_range();
+    }
+
+    template<class K = key_type>
+    const mapped_type& at(const key_arg<K>& k) const {
+        return const_cast<this_type*>(this)->at(k);
+    }
+
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k) const noexcept {
+        return find_pos_rh_(k, (*this)(k)) != SIZE_MAX;
+    }
+
+    template<class K = key_type>
+    bool contains(const key_arg<K>& k) const noexcept {
+        return find_pos_rh_(k, (*this)(k)) != SIZE_MAX;
+    }
+
+    //lookups by hash of k computed before, see insert(val, hash)
+    template<class K = key_type>
+    iterator find(const key_arg<K>& k, size_t hash) noexcept {
+        size_t i = find_pos_rh_(k, hash);
+        return (i != SIZE_MAX) ? iterator(data_<this_type>() + i, _elements + i, 0) : iterator();
+    }
+
+    template<class K = key_type>
+    const_iterator find(const key_arg<K>& k, size_t hash) const noexcept {
+        return const_cast<this_type*>(this)->find(k, hash);
+    }
+
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_pos_rh_(k, hash) != SIZE_MAX;
+    }
+
+    template<class K = key_type>
+    bool contains(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_pos_rh_(k, hash) != SIZE_MAX;
+    }
+
+    /*! Can invalidate iterators, erase during iteration visits every element once.
+    * \params it - Iterator pointing to a single element to be removed
+    * \return return an iterator pointing to the position immediately following of the element erased
+    */
+    iterator erase(const_iterator it) noexcept
+    {
+        auto& ret = (iterator&)it;
+        if (HRD_LIKELY(!!it._ptr))
         {
-            i &= _capacity;
-            auto* r = ee + i;
-            auto h = _elements[i];
-            if (EMPTY_MARK == h)
-            {
-                if (HRD_UNLIKELY(empty_spot != SIZE_MAX)) {
-                    r = ee + empty_spot;
-                    i = empty_spot;
-                }
+            it._ptr->data.~value_type();
+            _size--;
+            shift_back_(it._mark - _elements);
 
-                new ((void*)&r->data) value_type(std::forward<V>(k), mapped_type());
-                _elements[i] = USED_MARK;
-                _size++;
-                if (HRD_UNLIKELY(empty_spot != SIZE_MAX)) _erased--;
-                return r->data.second;
+            if (HRD_UNLIKELY(ret._cnt)) { //following elements of the cluster moved back by one slot, one wrapped to the end is the last one
+                --ret._cnt;
+                size_t step = next_used(ret._mark);
+                ret._mark += step;
+                ret._ptr += step;
+                return ret;
             }
-            if (USED_MARK == h)
-            {
-                if (HRD_LIKELY(hash_pred::operator()(r->data.first, k))) //identical found
-                    return r->data.second;
+            it._ptr = nullptr;
+        }
+        return ret;
+    }
+
+    //exact match for iterator argument, erase(key_arg<K>) of transparent table takes it otherwise
+    iterator erase(iterator it) noexcept {
+        return erase(const_iterator(it));
+    }
+
+    /*! Can invalidate iterators.
+    * \params k - Key of the element to be erased
+    * \return 1 - if element erased and zero otherwise
+    */
+    template<class K = key_type>
+    size_type erase(const key_arg<K>& k) noexcept {
+        return erase(k, (*this)(k));
+    }
+
+    template<class K = key_type>
+    size_type erase(const key_arg<K>& k, size_t hash) noexcept
+    {
+        size_t i = find_pos_rh_(k, hash);
+        if (i == SIZE_MAX)
+            return 0;
+
+        data_<this_type>()[i].data.~value_type();
+        _size--;
+        shift_back_(i);
+        return 1;
+    }
+
+    void shrink_to_fit() {
+        if (HRD_LIKELY(_size)) {
+            size_t pow2 = calc_pow2(_size);
+            if (HRD_LIKELY((_capacity + 1) != pow2))
+                resize_rh_(pow2);
+        }
+        else
+            hash_base::clear<this_type>(std::true_type());
+    }
+
+    hash_map_rh& operator=(const hash_map_rh& r) {
+        this_type(r).swap(*this);
+        return *this;
+    }
+
+    hash_map_rh& operator=(hash_map_rh&& r) noexcept {
+        swap(r);
+        return *this;
+    }
+
+    mapped_type& operator[](const key_type& k) {
+        return emplace_(k).first->second;
+    }
+
+    mapped_type& operator[](key_type&& k) {
+        return emplace_(std::move(k)).first->second;
+    }
+
+    //operator[] by hash of k computed before, see insert(val, hash)
+    mapped_type& find_insert(const key_type& k, size_t hash) {
+        return emplace_hashed_(hash, k).first->second;
+    }
+
+    mapped_type& find_insert(key_type&& k, size_t hash) {
+        return emplace_hashed_(hash, std::move(k)).first->second;
+    }
+
+    //longest probe sequence of the stored elements (0 - every element in own home slot)
+    size_type max_probe() const noexcept {
+        size_t ret = 0;
+        auto* ee = data_<this_type>();
+        for (size_t i = 0, cnt = _size; cnt; ++i) {
+            i += next_used(_elements + i);
+            ret = (std::max)(ret, dist_(i, ee));
+            --cnt;
+        }
+        return ret;
+    }
+
+private:
+    //resize target: keeps hasher/key_equal state of the source table, its dist_() rehashes saturated slots by the same hasher
+    hash_map_rh(size_type pow2, bool, const allocator_type& alloc, const hash_pred& hp) : hash_pred(hp), Alloc(alloc) {
+        ctor_pow2<this_type>(pow2);
+    }
+
+    HRD_ALWAYS_INLINE static std::byte dist_mark_(size_t dist) noexcept {
+        return USED_MARK | std::byte((uint8_t)((dist < DIST_SATURATED) ? dist : DIST_SATURATED));
+    }
+
+    //probe distance of element in used slot i
+    HRD_ALWAYS_INLINE size_t dist_(size_t i, const storage_type* ee) const noexcept
+    {
+        size_t dist = (size_t)(_elements[i] & std::byte{ DIST_SATURATED });
+        if (HRD_UNLIKELY(dist == DIST_SATURATED))
+            dist = (i - (*this)(ee[i].data.first)) & _capacity;
+        return dist;
+    }
+
+    //key moved out of element which is destroyed right after
+    HRD_ALWAYS_INLINE static void relocate_(storage_type* dst, storage_type* src) noexcept
+    {
+        if constexpr (IS_TRIVIALLY_COPYABLE::value)
+            memcpy((void*)dst, src, sizeof(storage_type));
+        else {
+            new ((void*)&dst->data) value_type(std::move(const_cast<key_type&>(src->data.first)), std::move(src->data.second));
+            src->data.~value_type();
+        }
+    }
+
+    /** Probe for k: {index of equal element, true} or {index to place k, false}.
+     * Mark of slot "dist" steps from home compared with mark k would have there: less - empty slot or element closer to its home.
+     */
+    template<typename K>
+    HRD_ALWAYS_INLINE std::pair<size_t, bool> probe_rh_(const K& k, size_t h) const noexcept
+    {
+        auto* ee = data_<this_type>();
+        size_t i = h & _capacity;
+        for (size_t dist = 0;; ++dist, i = (i + 1) & _capacity)
+        {
+            const std::byte mark = _elements[i];
+            const std::byte expected = dist_mark_(dist);
+            if ((uint8_t)mark < (uint8_t)expected)
+                return std::pair<size_t, bool>(i, false);
+
+            if (mark == expected) {
+                if (HRD_UNLIKELY(dist >= DIST_SATURATED)) {
+                    size_t actual = dist_(i, ee);
+                    if (actual < dist)
+                        return std::pair<size_t, bool>(i, false);
+                    if (actual != dist)
+                        continue;
+                }
+                if (HRD_LIKELY((*this)(ee[i].data.first, k)))
+                    return std::pair<size_t, bool>(i, true);
             }
-            else if (match_mark == h)
+        }
+    }
+
+    template<typename K>
+    HRD_ALWAYS_INLINE size_t find_pos_rh_(const K& k, size_t h) const noexcept {
+        auto pos = probe_rh_(k, h);
+        return pos.second ? pos.first : SIZE_MAX;
+    }
+
+    //move elements of [i, first empty slot) forward by one slot, i becomes free (its mark is not changed)
+    HRD_ALWAYS_INLINE void shift_forward_(size_t i) noexcept
+    {
+        auto* ee = data_<this_type>();
+        size_t j = i;
+        while (EMPTY_MARK != _elements[j])
+            j = (j + 1) & _capacity;
+
+        for (; j != i; j = (j - 1) & _capacity) {
+            size_t prev = (j - 1) & _capacity;
+            relocate_(ee + j, ee + prev);
+            uint8_t mark = (uint8_t)_elements[prev];
+            _elements[j] = std::byte(mark + (mark < (0x80 | DIST_SATURATED)));
+        }
+    }
+
+    //slot i is free: move following elements of the cluster back by one slot
+    HRD_ALWAYS_INLINE void shift_back_(size_t i) noexcept
+    {
+        auto* ee = data_<this_type>();
+        for (size_t j = (i + 1) & _capacity;; i = j, j = (j + 1) & _capacity)
+        {
+            const std::byte mark = _elements[j];
+            if (EMPTY_MARK == mark || USED_MARK == mark) { //empty or element in its home
+                _elements[i] = EMPTY_MARK;
+                return;
+            }
+            size_t dist = dist_(j, ee);
+            relocate_(ee + i, ee + j);
+            _elements[i] = dist_mark_(dist - 1);
+        }
+    }
+
+    template<typename K, typename... Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace_(K&& k, Args&&... args) {
+        return emplace_hashed_((*this)(k), std::forward<K>(k), std::forward<Args>(args)...);
+    }
+
+    //h - hash of k
+    template<typename K, typename... Args>
+    std::pair<iterator, bool> emplace_hashed_(size_t h, K&& k, Args&&... args)
+    {
+        if (HRD_UNLIKELY(_size >= _gap))
+            resize_rh_(2 * (_capacity + 1));
+
+        auto* ee = data_<this_type>();
+        auto pos = probe_rh_(k, h);
+        size_t i = pos.first;
+        if (pos.second) //identical found
+            return std::pair<iterator, bool>(iterator(ee + i, _elements + i, 0), false);
+
+        if (EMPTY_MARK != _elements[i])
+            shift_forward_(i);
+        try {
+            new ((void*)&ee[i].data) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(k)), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        catch (...) {
+            shift_back_(i);
+            throw;
+        }
+        _elements[i] = dist_mark_((i - h) & _capacity);
+        _size++;
+        return std::pair<iterator, bool>(iterator(ee + i, _elements + i, 0), true);
+    }
+
+    //relocate all elements to new storage of pow2 slots
+    void resize_rh_(size_t pow2)
+    {
+        this_type tmp(pow2, false, get_allocator(), static_cast<const hash_pred&>(*this));
+        if (size_t cnt = _size)
+        {
+            auto* src_ee = data_<this_type>();
+            auto* dst_ee = tmp.template data_<this_type>();
+            for (size_t i = 0;; ++i)
             {
-                match_mark = EMPTY_MARK; //use first found empty spot
-                empty_spot = i;
+                i += next_used(_elements + i);
+                size_t h = (*this)(src_ee[i].data.first);
+                size_t j = h & tmp._capacity;
+                for (size_t dist = 0; (uint8_t)tmp._elements[j] >= (uint8_t)dist_mark_(dist) &&
+                    (dist < DIST_SATURATED || tmp.dist_(j, dst_ee) >= dist); ++dist)
+                    j = (j + 1) & tmp._capacity;
+
+                if (EMPTY_MARK != tmp._elements[j])
+                    tmp.shift_forward_(j);
+                relocate_(dst_ee + j, src_ee + i);
+                tmp._elements[j] = dist_mark_((j - h) & tmp._capacity);
+                if (!--cnt)
+                    break;
             }
+            tmp._size = _size;
+            _size = 0;
+        }
+        swap(tmp);
+    }
+
+    void ctor_copy_rh_(std::true_type, const this_type& ref) {
+        ctor_copy(std::true_type(), ref);
+    }
+
+    //same slots and marks as in ref
+    void ctor_copy_rh_(std::false_type, const this_type& ref)
+    {
+        if (!ref._size) {
+            ctor_empty();
+            return;
         }
+        ctor_pow2<this_type>(ref._capacity + 1);
+        dtor_if_throw_constructible<this_type> tmp(*this);
+
+        auto* dst_ee = data_<this_type>();
+        auto* src_ee = ref.template data_<this_type>();
+        for (size_t i = 0, cnt = ref._size; cnt; ++i, --cnt) {
+            i += next_used(ref._elements + i);
+            new ((void*)&dst_ee[i].data) value_type(src_ee[i].data);
+            _elements[i] = ref._elements[i];
+            _size++;
+        }
+        tmp.reset();
     }
 };
 
-#pragma endregion hash_map
+#pragma endregion hash_map_rh
 
 #pragma region hash_grow_map
 
 //----------------------------------------- hash_grow_map -----------------------------------------
 
-template<class Key, class T, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>>
-class hash_grow_map : public hash_base, public hash_base::hash_eql<Hash, Pred>
+template<class Key, class T, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>, class Alloc = malloc_allocator>
+class hash_grow_map : public hash_base, public hash_base::hash_eql<Hash, Pred>, private Alloc
 {
 public:
-    using this_type       = hash_grow_map<Key, T, Hash, Pred>;
+    using this_type       = hash_grow_map<Key, T, Hash, Pred, Alloc>;
+    using allocator_type  = Alloc;
     using key_type        = Key;
     using mapped_type     = T;
     using hasher_type     = Hash;
@@ -1947,28 +3655,42 @@ public:
     using iterator       = typename iterator_base<this_type>::iterator;
     using const_iterator = typename iterator_base<this_type>::const_iterator;
 
+    //key type of lookups, see hash_base::lookup_key
+    template<class K>
+    using key_arg = typename lookup_key<Hash, Pred>::template type<K, key_type>;
+
     hash_grow_map() {
         ctor_empty();
     }
 
-    hash_grow_map(const hash_grow_map& r) : hash_pred(r) {
+    hash_grow_map(const hash_grow_map& r) : hash_pred(r), Alloc(r.get_allocator()) {
         ctor_copy(IS_TRIVIALLY_COPYABLE(), r);
     }
 
-    hash_grow_map(hash_grow_map&& r) noexcept : hash_pred(std::move(r)) {
+    hash_grow_map(hash_grow_map&& r) noexcept : hash_pred(std::move(r)), Alloc(std::move(static_cast<Alloc&>(r))) {
         ctor_move(std::move(r));
     }
 
-    hash_grow_map(size_type hint_size, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : hash_pred(hf, eql) {
-        ctor_pow2<this_type>(calc_pow2(hint_size), sizeof(storage_type));
+    explicit hash_grow_map(const allocator_type& alloc) : Alloc(alloc) {
+        ctor_empty();
+    }
+
+    hash_grow_map(size_type hint_size, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
+        ctor_pow2<this_type>(calc_pow2(hint_size));
     }
 
     template<typename Iter>
-    hash_grow_map(Iter first, Iter last, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : hash_pred(hf, eql) {
+    hash_grow_map(Iter first, Iter last, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
         ctor_iters(first, last, *this, typename std::iterator_traits<Iter>::iterator_category());
     }
 
-    hash_grow_map(std::initializer_list<value_type> lst, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : hash_pred(hf, eql) {
+    hash_grow_map(std::initializer_list<value_type> lst, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+        hash_pred(hf, eql), Alloc(alloc)
+    {
         ctor_init_list(lst, *this);
     }
 
@@ -2016,6 +3738,11 @@ public:
     void swap(hash_grow_map& r) noexcept {
         hash_base::swap(r);
         hash_pred::swap(r);
+        std::swap(static_cast<Alloc&>(*this), static_cast<Alloc&>(r));
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return static_cast<const Alloc&>(*this);
     }
 
     std::pair<iterator, bool> insert(const value_type& val) {
@@ -2047,33 +3774,126 @@ public:
         return emplace_(std::forward<K>(key), std::forward<Args>(args)...);
     }
 
-    iterator find(const key_type& k) noexcept {
+    /*! Can invalidate iterators. Probes first: mapped value constructed from args only if k is absent, args untouched otherwise.
+    * \return iterator to the element with key k and true if inserted
+    */
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+        return emplace_(k, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+        return emplace_(std::move(k), std::forward<Args>(args)...);
+    }
+
+    /*! Can invalidate iterators. obj assigned to mapped value of present k, inserted with k (constructed from obj) otherwise.
+    * \return iterator to the element with key k and true if inserted
+    */
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+        auto ret = emplace_(k, std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+        auto ret = emplace_(std::move(k), std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+
+    /*! Can invalidate iterators.
+    * \params hash - hash of val.first computed before by hasher(), operations on the same key in several tables hash it once
+    */
+    std::pair<iterator, bool> insert(const value_type& val, size_t hash) {
+        return insert_(val, hash, *this, std::false_type(), std::false_type());
+    }
+
+    std::pair<iterator, bool> insert(value_type&& val, size_t hash) {
+        return insert_(std::move(val), hash, *this, std::false_type(), std::false_type());
+    }
+
+    template<class K = key_type>
+    iterator find(const key_arg<K>& k) noexcept {
         return find_iter_(k, *this, std::false_type());
     }
 
-    const_iterator find(const key_type& k) const noexcept {
+    template<class K = key_type>
+    const_iterator find(const key_arg<K>& k) const noexcept {
         return find_iter_(k, *this, std::false_type());
     }
 
-	mapped_type& at(const key_type& k) {
+	template<class K = key_type>
+	mapped_type& at(const key_arg<K>& k) {
 		if (auto* p = find_(k, *this, std::false_type()))
 			return p->data.second;
 		throw_out_of_range();
 	}
 
-	const mapped_type& at(const key_type& k) const {
+	template<class K = key_type>
+	const mapped_type& at(const key_arg<K>& k) const {
 		if (auto* p = find_(k, *this, std::false_type()))
 			return p->data.second;
 		throw_out_of_range();
 	}
 
-    size_type count(const key_type& k) const noexcept {
-        return find_(k, *this, std::false_type()) != nullptr;
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k) const noexcept {
+        return find_(k, *this, std::false_type()) != nullptr;
+    }
+
+	template<class K = key_type>
+	bool contains(const key_arg<K>& k) const noexcept {
+		return find_(k, *this, std::false_type()) != nullptr;
+	}
+
+    //lookups by hash of k computed before, see insert(val, hash)
+    template<class K = key_type>
+    iterator find(const key_arg<K>& k, size_t hash) noexcept {
+        return find_iter_(k, hash, *this, std::false_type());
+    }
+
+    template<class K = key_type>
+    const_iterator find(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_iter_(k, hash, *this, std::false_type());
+    }
+
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash, *this, std::false_type()) != nullptr;
+    }
+
+    template<class K = key_type>
+    bool contains(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash, *this, std::false_type()) != nullptr;
     }
 
-	bool contains(const key_type& k) const noexcept {
-		return find_(k, *this, std::false_type()) != nullptr;
-	}
+    /*! Lookup of keys [first, last) by batches: keys hashed and their slots prefetched before probing.
+    * \params out - receives find() result for every key in order (Iter must be multi-pass)
+    * \return out past the last written result
+    */
+    template<typename Iter, typename Out>
+    Out find_many(Iter first, Iter last, Out out) {
+        return find_many_<iterator>(first, last, out, *this);
+    }
+
+    template<typename Iter, typename Out>
+    Out find_many(Iter first, Iter last, Out out) const {
+        return find_many_<const_iterator>(first, last, out, *this);
+    }
+
+    /*! Batched contains(), see find_many().
+    * \params out - receives bool for every key in order
+    * \return number of found keys
+    */
+    template<typename Iter, typename Out>
+    size_type contains_many(Iter first, Iter last, Out out) const {
+        return contains_many_(first, last, out, *this);
+    }
 
     void shrink_to_fit() {
         hash_base::shrink_to_fit_impl<this_type>(*this);
@@ -2090,11 +3910,20 @@ public:
     }
 
     mapped_type& operator[](const key_type& k) {
-        return find_insert(k);
+        return find_insert_(k, (*this)(k));
     }
 
     mapped_type& operator[](key_type&& k) {
-        return find_insert(std::move(k));
+        return find_insert_(std::move(k), (*this)(k));
+    }
+
+    //operator[] by hash of k computed before, see insert(val, hash)
+    mapped_type& find_insert(const key_type& k, size_t hash) {
+        return find_insert_(k, hash);
+    }
+
+    mapped_type& find_insert(key_type&& k, size_t hash) {
+        return find_insert_(std::move(k), hash);
     }
 
 	// Index of an element. Actual only if no reallocation happens after
@@ -2113,8 +3942,8 @@ public:
 	}
 
 private:
-    hash_grow_map(size_type pow2, bool) {
-        ctor_pow2<this_type>(pow2, sizeof(storage_type));
+    hash_grow_map(size_type pow2, bool, const allocator_type& alloc) : Alloc(alloc) {
+        ctor_pow2<this_type>(pow2);
     }
 
     template<typename K, typename... Args>
@@ -2125,46 +3954,35 @@ private:
 
         auto* ee = reinterpret_cast<storage_type*>(_elements + align_ppow2<this_type>(_capacity));
 
-        for (size_t i = hash_pred::operator()(k);; ++i)
-        {
-            i &= _capacity;
-            auto* r = ee + i;
-            int32_t h = _elements[i];
-            if (!h)
-            {
-                std::pair<iterator, bool> ret(iterator(r, _elements + i), true);
-                new ((void*)&r->data) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(k)), std::forward_as_tuple(std::forward<Args>(args)...));
-                _elements[i] = USED_MARK;
-                _size++;
-                return ret;
-            }
-            if (HRD_LIKELY(hash_pred::operator()(r->data.first, k))) //identical found
-                return std::pair<iterator, bool>(iterator(r, _elements + i), false);
-        }
+        size_t h = (*this)(k);
+        auto pos = insert_pos_(k, h, *this, std::false_type());
+        auto* r = ee + pos.first;
+        if (pos.second) //identical found
+            return std::pair<iterator, bool>(iterator(r, _elements + pos.first), false);
+
+        new ((void*)&r->data) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(k)), std::forward_as_tuple(std::forward<Args>(args)...));
+        _elements[pos.first] = make_mark(h);
+        _size++;
+        return std::pair<iterator, bool>(iterator(r, _elements + pos.first), true);
     }
 
     template<typename V>
-    HRD_ALWAYS_INLINE mapped_type& find_insert(V&& k)
+    HRD_ALWAYS_INLINE mapped_type& find_insert_(V&& k, size_t h)
     {
 		if (HRD_UNLIKELY(this->_size >= this->_gap))
             resize_pow2(2 * (_capacity + 1), *this);
 
         auto* ee = reinterpret_cast<storage_type*>(_elements + align_ppow2<this_type>(_capacity));
 
-        for (size_t i = hash_pred::operator()(k);; ++i)
-        {
-            i &= _capacity;
-            auto* r = ee + i;
-            if (EMPTY_MARK == _elements[i])
-            {
-                new ((void*)&r->data) value_type(std::forward<V>(k), mapped_type());
-                _elements[i] = USED_MARK;
-                _size++;
-                return r->data.second;
-            }
-            if (HRD_LIKELY(hash_pred::operator()(r->data.first, k))) //identical found
-                return r->data.second;
-        }
+        auto pos = insert_pos_(k, h, *this, std::false_type());
+        auto* r = ee + pos.first;
+        if (pos.second) //identical found
+            return r->data.second;
+
+        new ((void*)&r->data) value_type(std::forward<V>(k), mapped_type());
+        _elements[pos.first] = make_mark(h);
+        _size++;
+        return r->data.second;
     }
 };
 
@@ -2289,7 +4107,8 @@ protected:
 		}
 	};
 	struct KHash {
-		size_t operator()(const Key& k) const noexcept {
+		template<typename K>
+		size_t operator()(const K& k) const noexcept {
 			return hash(k);
 		}
 
@@ -2307,7 +4126,8 @@ protected:
 			auto& k2 = key_getter::get_key((*vec)[ki2.idx]);
 			return pred(k1, k2);
 		}
-		bool operator()(KIndex ki1, const Key& k2) const noexcept {
+		template<typename K>
+		bool operator()(KIndex ki1, const K& k2) const noexcept {
 			auto& k1 = key_getter::get_key((*vec)[ki1.idx]);
 			return pred(k1, k2);
 		}
@@ -2341,6 +4161,10 @@ public:
 	using value_type      = const key_type;
 	using reference       = value_type&;
 	using const_reference = const value_type&;
+
+	//key type of lookups, see hash_base::lookup_key
+	template<class K>
+	using key_arg = typename hash_base::lookup_key<Hash, Pred>::template type<K, key_type>;
 	using base_type::size;
 	using base_type::empty;
 	using base_type::reserve;
@@ -2443,6 +4267,17 @@ public:
 		return insert(std::forward<P>(val));
 	}
 
+	///hash - hash of k computed before by Hash, KHash of the index table not called
+	std::pair<iterator, bool> insert(const Key& k, size_t hash) {
+		this->m_data.emplace_back(k);
+		return insert_(hash);
+	}
+
+	std::pair<iterator, bool> insert(Key&& k, size_t hash) {
+		this->m_data.emplace_back(std::move(k));
+		return insert_(hash);
+	}
+
 	template<typename Iter>
 	void insert(Iter first, Iter last) {
 		if (auto cnt = std::distance(first, last)) {
@@ -2459,21 +4294,40 @@ public:
 		}
 	}
 
-	const_iterator find(const Key& k) const noexcept {
+	template<class K = key_type>
+	const_iterator find(const key_arg<K>& k) const noexcept {
 		auto it = this->m_hset.find(k);
 		return (it != this->m_hset.end()) ? &this->m_data[it->idx] : end();
 	}
 
-	bool contains(const Key& k) const noexcept {
+	template<class K = key_type>
+	bool contains(const key_arg<K>& k) const noexcept {
 		auto it = this->m_hset.find(k);
 		return it != this->m_hset.end();
 	}
 
-	size_t count(const Key& k) const noexcept {
+	template<class K = key_type>
+	size_t count(const key_arg<K>& k) const noexcept {
 		auto it = this->m_hset.find(k);
 		return it != this->m_hset.end();
 	}
 
+	template<class K = key_type>
+	const_iterator find(const key_arg<K>& k, size_t hash) const noexcept {
+		auto it = this->m_hset.find(k, hash);
+		return (it != this->m_hset.end()) ? &this->m_data[it->idx] : end();
+	}
+
+	template<class K = key_type>
+	bool contains(const key_arg<K>& k, size_t hash) const noexcept {
+		return this->m_hset.find(k, hash) != this->m_hset.end();
+	}
+
+	template<class K = key_type>
+	size_t count(const key_arg<K>& k, size_t hash) const noexcept {
+		return this->m_hset.find(k, hash) != this->m_hset.end();
+	}
+
 	const_iterator cbegin() const { return this->m_data.data(); }
 	const_iterator begin() const { return this->cbegin(); }
 	iterator       begin() { return this->m_data.data(); }
@@ -2489,6 +4343,14 @@ private:
 			this->m_data.resize(ki.idx); //get size back
 		return { &this->m_data[pr.first->idx], pr.second };
 	}
+
+	HRD_ALWAYS_INLINE std::pair<iterator, bool> insert_(size_t hash) {
+		KIndex ki = { static_cast<typename KIndex::data_type>(this->m_data.size() - 1) };
+		auto pr = this->m_hset.insert(ki, hash);
+		if (!pr.second)
+			this->m_data.resize(ki.idx); //get size back
+		return { &this->m_data[pr.first->idx], pr.second };
+	}
 };
 
 #pragma endregion hash_grow_set_heavy
@@ -2513,6 +4375,11 @@ public:
 	using value_type      = std::pair<const key_type, mapped_type>;
 	using reference       = value_type&;
 	using const_reference = const value_type&;
+
+	//key type of lookups, see hash_base::lookup_key
+	template<class K>
+	using key_arg = typename hash_base::lookup_key<Hash, Pred>::template type<K, key_type>;
+
 	using base_type::size;
 	using base_type::empty;
 	using base_type::reserve;
@@ -2634,48 +4501,120 @@ public:
 		return insert(std::forward<P>(val));
 	}
 
+	//probes first, value appended to data only if key is absent
 	template<class K, class... Args>
 	std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
-		this->m_data.emplace_back(std::forward<K>(key), std::forward<Args>(args)...);
-		return insert_();
+		key_type k(std::forward<K>(key));
+		return try_emplace_(this->m_hset(k), std::move(k), std::forward<Args>(args)...);
 	}
 
 	template<class... Args>
 	std::pair<iterator, bool> emplace(const Key& key, Args&&... args) {
-		this->m_data.emplace_back(key, std::forward<Args>(args)...);
-		return insert_();
+		return try_emplace_(this->m_hset(key), key, std::forward<Args>(args)...);
+	}
+
+	///mapped value constructed from args only if k is absent, nothing constructed or appended otherwise
+	template<class... Args>
+	std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+		return try_emplace_(this->m_hset(k), k, std::forward<Args>(args)...);
+	}
+
+	template<class... Args>
+	std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+		return try_emplace_(this->m_hset(k), std::move(k), std::forward<Args>(args)...);
+	}
+
+	///obj assigned to mapped value of present k, appended with k otherwise
+	template<class M>
+	std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+		auto ret = try_emplace(k, std::forward<M>(obj));
+		if (!ret.second)
+			ret.first->second = std::forward<M>(obj);
+		return ret;
+	}
+
+	template<class M>
+	std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+		auto ret = try_emplace(std::move(k), std::forward<M>(obj));
+		if (!ret.second)
+			ret.first->second = std::forward<M>(obj);
+		return ret;
+	}
+
+	///hash - hash of val.first computed before by Hash, KHash of the index table not called
+	std::pair<iterator, bool> insert(const value_type& val, size_t hash) {
+		this->m_data.emplace_back(val);
+		return insert_(hash);
+	}
+
+	std::pair<iterator, bool> insert(value_type&& val, size_t hash) {
+		this->m_data.emplace_back(std::move(val));
+		return insert_(hash);
 	}
 
 	mapped_type& operator[](const key_type& k) {
-		this->m_data.emplace_back(k, mapped_type{});
-		return insert_().first->second;
+		return try_emplace_(this->m_hset(k), k).first->second;
 	}
 
 	mapped_type& operator[](key_type&& k) {
-		this->m_data.emplace_back(std::move(k), mapped_type{});
-		return insert_().first->second;
+		return try_emplace_(this->m_hset(k), std::move(k)).first->second;
+	}
+
+	//operator[] by hash of k computed before
+	mapped_type& find_insert(const key_type& k, size_t hash) {
+		return try_emplace_(hash, k).first->second;
 	}
 
-	const_iterator find(const Key& k) const noexcept {
+	mapped_type& find_insert(key_type&& k, size_t hash) {
+		return try_emplace_(hash, std::move(k)).first->second;
+	}
+
+	template<class K = key_type>
+	const_iterator find(const key_arg<K>& k) const noexcept {
 		auto it = this->m_hset.find(k);
         return (it != this->m_hset.end()) ? &data()[it->idx] : end();
 	}
 	
-	iterator find(const Key& k) noexcept {
+	template<class K = key_type>
+	iterator find(const key_arg<K>& k) noexcept {
 		auto it = this->m_hset.find(k);
 		return (it != this->m_hset.end()) ? &data()[it->idx] : end();
 	}
 
-	bool contains(const Key& k) const noexcept {
+	template<class K = key_type>
+	bool contains(const key_arg<K>& k) const noexcept {
 		auto it = this->m_hset.find(k);
 		return it != this->m_hset.end();
 	}
 
-    size_t count(const Key& k) const noexcept {
+    template<class K = key_type>
+    size_t count(const key_arg<K>& k) const noexcept {
 		auto it = this->m_hset.find(k);
 		return it != this->m_hset.end();
     }
 
+	template<class K = key_type>
+	const_iterator find(const key_arg<K>& k, size_t hash) const noexcept {
+		auto it = this->m_hset.find(k, hash);
+		return (it != this->m_hset.end()) ? &data()[it->idx] : end();
+	}
+
+	template<class K = key_type>
+	iterator find(const key_arg<K>& k, size_t hash) noexcept {
+		auto it = this->m_hset.find(k, hash);
+		return (it != this->m_hset.end()) ? &data()[it->idx] : end();
+	}
+
+	template<class K = key_type>
+	bool contains(const key_arg<K>& k, size_t hash) const noexcept {
+		return this->m_hset.find(k, hash) != this->m_hset.end();
+	}
+
+	template<class K = key_type>
+	size_t count(const key_arg<K>& k, size_t hash) const noexcept {
+		return this->m_hset.find(k, hash) != this->m_hset.end();
+	}
+
 	const_iterator cbegin() const { return data(); }
 	const_iterator begin() const { return cbegin(); }
 	iterator       begin() { return data(); }
@@ -2695,8 +4634,496 @@ private:
 			this->m_data.resize(ki.idx); //get size back
         return { { &data()[pr.first->idx] }, pr.second };
 	}
+
+	HRD_ALWAYS_INLINE std::pair<iterator, bool> insert_(size_t hash) {
+		KIndex ki = { static_cast<typename KIndex::data_type>(this->m_data.size() - 1) };
+		auto pr = this->m_hset.insert(ki, hash);
+		if (!pr.second)
+			this->m_data.resize(ki.idx); //get size back
+		return { { &data()[pr.first->idx] }, pr.second };
+	}
+
+	//hash - hash of k, data appended only if k is absent
+	template<class K, class... Args>
+	HRD_ALWAYS_INLINE std::pair<iterator, bool> try_emplace_(size_t hash, K&& k, Args&&... args) {
+		auto it = this->m_hset.find(k, hash);
+		if (it != this->m_hset.end())
+			return { { &data()[it->idx] }, false };
+
+		this->m_data.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(k)), std::forward_as_tuple(std::forward<Args>(args)...));
+		return insert_(hash);
+	}
 };
 
 #pragma endregion hash_grow_map_heavy
 
+#pragma region incremental_base
+
+///Resize without full rehash inside one call: while resizing "old" storage is kept together with "current" (twice bigger) one,
+///each modifying call moves HRD_REHASH_STEP slots of "old" to "current". Lookups check both, insertions go to "current" only.
+///Any modifying call invalidates iterators (erase by iterator returns valid next one).
+template<class table_type>
+class incremental_base {
+public:
+	using size_type   = typename table_type::size_type;
+	using key_type    = typename table_type::key_type;
+	using value_type  = typename table_type::value_type;
+	using hasher_type = typename table_type::hasher_type;
+	using keyeql_type = typename table_type::keyeql_type;
+	using allocator_type = typename table_type::allocator_type;
+
+	template<class table_iterator>
+	class iterator_t {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = typename table_iterator::value_type;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = typename table_iterator::pointer;
+		using reference         = typename table_iterator::reference;
+
+		iterator_t() = default;
+
+		template<class I>
+		iterator_t(const iterator_t<I>& r) noexcept : m_it(r.m_it), m_next(r.m_next) {}
+
+		decltype(auto) operator*() const noexcept { return *table_iterator(m_it); }
+		auto operator->() const noexcept { return &*table_iterator(m_it); }
+
+		bool operator==(const iterator_t& r) const noexcept { return m_it == r.m_it; }
+		bool operator!=(const iterator_t& r) const noexcept { return m_it != r.m_it; }
+
+		iterator_t& operator++() noexcept {
+			++m_it;
+			skip_end();
+			return *this;
+		}
+
+		iterator_t operator++(int) noexcept {
+			iterator_t temp = *this;
+			++(*this);
+			return temp;
+		}
+
+	private:
+		friend class incremental_base;
+		template<class I> friend class iterator_t;
+
+		iterator_t(table_iterator it, table_type* next) noexcept : m_it(it), m_next(next) { skip_end(); }
+
+		HRD_ALWAYS_INLINE void skip_end() noexcept {
+			if (HRD_UNLIKELY(m_it == table_iterator()) && m_next) {
+				m_it = m_next->begin();
+				m_next = nullptr;
+			}
+		}
+
+		table_iterator m_it;
+		table_type* m_next{ nullptr }; //"old" table to continue with after the end of "current" one
+	};
+	using iterator       = iterator_t<typename table_type::iterator>;
+	using const_iterator = iterator_t<typename table_type::const_iterator>;
+
+	template<class K>
+	using key_arg = typename table_type::template key_arg<K>;
+
+	incremental_base() = default;
+
+	incremental_base(size_type hint, const hasher_type& hf, const keyeql_type& eql, const allocator_type& alloc) : m_cur(hint, hf, eql, alloc), m_old(0, hf, eql, alloc) {
+		m_old.clear();
+	}
+
+	allocator_type get_allocator() const noexcept { return m_cur.get_allocator(); }
+
+	size_type size() const noexcept { return m_cur.size() + m_old.size(); }
+	bool empty() const noexcept { return !size(); }
+
+	///true if elements of previous storage are not moved completely yet
+	bool rehashing() const noexcept { return m_old.capacity() != 0; }
+
+	///move all the rest elements of previous storage at once
+	void finish_rehash() {
+		if (rehashing())
+			move_(SIZE_MAX);
+	}
+
+	void reserve(size_type hint) {
+		finish_rehash();
+		m_cur.reserve(hint);
+	}
+
+	void clear() noexcept {
+		m_cur.clear();
+		m_old.clear();
+		m_pos = 0;
+	}
+
+	void swap(incremental_base& r) noexcept {
+		m_cur.swap(r.m_cur);
+		m_old.swap(r.m_old);
+		std::swap(m_pos, r.m_pos);
+	}
+
+	iterator begin() noexcept { return iterator(m_cur.begin(), next_()); }
+	const_iterator begin() const noexcept { return cbegin(); }
+	const_iterator cbegin() const noexcept { return const_cast<incremental_base*>(this)->begin(); }
+	iterator end() noexcept { return iterator(); }
+	const_iterator end() const noexcept { return const_iterator(); }
+	const_iterator cend() const noexcept { return const_iterator(); }
+
+	template<class K = key_type>
+	iterator find(const key_arg<K>& k) noexcept {
+		auto it = m_cur.find(k);
+		if (it != m_cur.end())
+			return iterator(it, next_());
+		return rehashing() ? iterator(m_old.find(k), nullptr) : end();
+	}
+
+	template<class K = key_type>
+	const_iterator find(const key_arg<K>& k) const noexcept {
+		return const_cast<incremental_base*>(this)->find(k);
+	}
+
+	template<class K = key_type>
+	bool contains(const key_arg<K>& k) const noexcept {
+		return m_cur.contains(k) || (rehashing() && m_old.contains(k));
+	}
+
+	template<class K = key_type>
+	size_type count(const key_arg<K>& k) const noexcept {
+		return contains(k);
+	}
+
+	///lookups by hash of k computed before by hasher, valid for both storages
+	template<class K = key_type>
+	iterator find(const key_arg<K>& k, size_t hash) noexcept {
+		auto it = m_cur.find(k, hash);
+		if (it != m_cur.end())
+			return iterator(it, next_());
+		return rehashing() ? iterator(m_old.find(k, hash), nullptr) : end();
+	}
+
+	template<class K = key_type>
+	const_iterator find(const key_arg<K>& k, size_t hash) const noexcept {
+		return const_cast<incremental_base*>(this)->find(k, hash);
+	}
+
+	template<class K = key_type>
+	bool contains(const key_arg<K>& k, size_t hash) const noexcept {
+		return m_cur.contains(k, hash) || (rehashing() && m_old.contains(k, hash));
+	}
+
+	template<class K = key_type>
+	size_type count(const key_arg<K>& k, size_t hash) const noexcept {
+		return contains(k, hash);
+	}
+
+	/*! Can invalidate iterators.
+	* \params it - Iterator pointing to a single element to be removed
+	* \return return an iterator pointing to the position immediately following of the element erased
+	*/
+	iterator erase(const_iterator it) noexcept {
+		if (it.m_next || !rehashing()) //iterator of "current" table
+			return iterator(m_cur.erase(it.m_it), it.m_next);
+		return iterator(m_old.erase(it.m_it), nullptr);
+	}
+
+	iterator erase(iterator it) noexcept {
+		return erase(const_iterator(it));
+	}
+
+	template<class K = key_type>
+	size_type erase(const key_arg<K>& k) {
+		step_();
+		if (m_cur.erase(k))
+			return 1;
+		return rehashing() ? m_old.erase(k) : 0;
+	}
+
+	template<class K = key_type>
+	size_type erase(const key_arg<K>& k, size_t hash) {
+		step_();
+		if (m_cur.erase(k, hash))
+			return 1;
+		return rehashing() ? m_old.erase(k, hash) : 0;
+	}
+
+protected:
+	//insert by "ins(table)" into "current" table if k is absent in "old" one
+	template<typename K, typename F>
+	HRD_ALWAYS_INLINE std::pair<iterator, bool> insert_(const K& k, F&& ins) {
+		grow_();
+		if (rehashing()) {
+			auto it = m_old.find(k);
+			if (it != m_old.end())
+				return { iterator(it, nullptr), false };
+		}
+		auto pr = ins(m_cur);
+		return { iterator(pr.first, next_()), pr.second };
+	}
+
+	//insert_ with hash of k computed before
+	template<typename K, typename F>
+	HRD_ALWAYS_INLINE std::pair<iterator, bool> insert_(const K& k, size_t hash, F&& ins) {
+		grow_();
+		if (rehashing()) {
+			auto it = m_old.find(k, hash);
+			if (it != m_old.end())
+				return { iterator(it, nullptr), false };
+		}
+		auto pr = ins(m_cur);
+		return { iterator(pr.first, next_()), pr.second };
+	}
+
+	HRD_ALWAYS_INLINE table_type* next_() noexcept {
+		return rehashing() ? &m_old : nullptr;
+	}
+
+	HRD_ATTR_NORETURN static void throw_out_of_range() {
+		hash_base::throw_out_of_range();
+	}
+
+	table_type m_cur;
+	table_type m_old;
+
+private:
+	HRD_ALWAYS_INLINE void grow_() {
+		if (HRD_UNLIKELY(m_cur._size + m_cur._erased >= m_cur._gap)) {
+			finish_rehash(); //"current" table filled up before "old" one moved, unlikely
+			m_old.swap(m_cur);
+			m_cur.resize_pow2(2 * (m_old._capacity + 1), m_cur);
+		}
+		step_();
+	}
+
+	HRD_ALWAYS_INLINE void step_() {
+		if (HRD_UNLIKELY(rehashing()))
+			move_(HRD_REHASH_STEP);
+	}
+
+	HRD_ATTR_NOINLINE void move_(size_t count) {
+		m_pos = m_old.move_slots_(m_cur, m_pos, count);
+		if (!m_old._size) {
+			m_old.clear();
+			m_pos = 0;
+		}
+	}
+
+	size_t m_pos{ 0 }; //next slot of "old" table to move
+};
+
+#pragma endregion incremental_base
+
+#pragma region hash_incremental_set
+
+///hash_set without long pause on resize: elements are moved to new storage by HRD_REHASH_STEP slots per modifying call
+template<class Key, class Hash = hrd::hash_base::hash_<Key>, class Pred = std::equal_to<Key>, class Alloc = malloc_allocator>
+class hash_incremental_set : public incremental_base<hash_set<Key, Hash, Pred, Alloc>> {
+	using base_type  = incremental_base<hash_set<Key, Hash, Pred, Alloc>>;
+	using table_type = hash_set<Key, Hash, Pred, Alloc>;
+public:
+	using typename base_type::hasher_type;
+	using typename base_type::keyeql_type;
+	using typename base_type::allocator_type;
+	using typename base_type::iterator;
+	using typename base_type::const_iterator;
+	using this_type       = hash_incremental_set<Key, Hash, Pred, Alloc>;
+	using key_type        = Key;
+	using value_type      = const key_type;
+	using reference       = value_type&;
+	using const_reference = const value_type&;
+
+	hash_incremental_set() = default;
+	hash_incremental_set(size_t hint, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+		base_type(hint, hf, eql, alloc) {}
+
+	std::pair<iterator, bool> insert(const key_type& k) {
+		return this->insert_(k, [&](table_type& t) { return t.insert(k); });
+	}
+
+	std::pair<iterator, bool> insert(key_type&& k) {
+		return this->insert_(k, [&](table_type& t) { return t.insert(std::move(k)); });
+	}
+
+	template<class K>
+	std::pair<iterator, bool> emplace(K&& k) {
+		return insert(key_type(std::forward<K>(k)));
+	}
+
+	std::pair<iterator, bool> insert(const key_type& k, size_t hash) {
+		return this->insert_(k, hash, [&](table_type& t) { return t.insert(k, hash); });
+	}
+
+	std::pair<iterator, bool> insert(key_type&& k, size_t hash) {
+		return this->insert_(k, hash, [&](table_type& t) { return t.insert(std::move(k), hash); });
+	}
+};
+
+#pragma endregion hash_incremental_set
+
+#pragma region hash_incremental_map
+
+///hash_map without long pause on resize: elements are moved to new storage by HRD_REHASH_STEP slots per modifying call
+template<class Key, class T, class Hash = hrd::hash_base::hash_<Key>, class Pred = std::equal_to<Key>, class Alloc = malloc_allocator>
+class hash_incremental_map : public incremental_base<hash_map<Key, T, Hash, Pred, Alloc>> {
+	using base_type  = incremental_base<hash_map<Key, T, Hash, Pred, Alloc>>;
+	using table_type = hash_map<Key, T, Hash, Pred, Alloc>;
+public:
+	using typename base_type::hasher_type;
+	using typename base_type::keyeql_type;
+	using typename base_type::allocator_type;
+	using typename base_type::iterator;
+	using typename base_type::const_iterator;
+	using this_type       = hash_incremental_map<Key, T, Hash, Pred, Alloc>;
+	using key_type        = Key;
+	using mapped_type     = T;
+	using value_type      = std::pair<const key_type, mapped_type>;
+	using reference       = value_type&;
+	using const_reference = const value_type&;
+
+	template<class K>
+	using key_arg = typename base_type::template key_arg<K>;
+
+	hash_incremental_map() = default;
+	hash_incremental_map(size_t hint, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type(), const allocator_type& alloc = allocator_type()) :
+		base_type(hint, hf, eql, alloc) {}
+
+	std::pair<iterator, bool> insert(const value_type& val) {
+		return this->insert_(val.first, [&](table_type& t) { return t.insert(val); });
+	}
+
+	std::pair<iterator, bool> insert(value_type&& val) {
+		return this->insert_(val.first, [&](table_type& t) { return t.insert(std::move(val)); });
+	}
+
+	template<class K, class... Args>
+	std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
+		return this->insert_(key, [&](table_type& t) { return t.emplace(std::forward<K>(key), std::forward<Args>(args)...); });
+	}
+
+	///mapped value constructed from args only if k is absent in both storages
+	template<class... Args>
+	std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+		return this->insert_(k, [&](table_type& t) { return t.try_emplace(k, std::forward<Args>(args)...); });
+	}
+
+	template<class... Args>
+	std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+		return this->insert_(k, [&](table_type& t) { return t.try_emplace(std::move(k), std::forward<Args>(args)...); });
+	}
+
+	template<class M>
+	std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+		auto ret = try_emplace(k, std::forward<M>(obj));
+		if (!ret.second)
+			ret.first->second = std::forward<M>(obj);
+		return ret;
+	}
+
+	template<class M>
+	std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+		auto ret = try_emplace(std::move(k), std::forward<M>(obj));
+		if (!ret.second)
+			ret.first->second = std::forward<M>(obj);
+		return ret;
+	}
+
+	std::pair<iterator, bool> insert(const value_type& val, size_t hash) {
+		return this->insert_(val.first, hash, [&](table_type& t) { return t.insert(val, hash); });
+	}
+
+	std::pair<iterator, bool> insert(value_type&& val, size_t hash) {
+		return this->insert_(val.first, hash, [&](table_type& t) { return t.insert(std::move(val), hash); });
+	}
+
+	mapped_type& operator[](const key_type& k) {
+		return emplace(k).first->second;
+	}
+
+	mapped_type& operator[](key_type&& k) {
+		return emplace(std::move(k)).first->second;
+	}
+
+	//operator[] by hash of k computed before
+	mapped_type& find_insert(const key_type& k, size_t hash) {
+		auto it = this->find(k, hash);
+		if (it != this->end())
+			return it->second;
+		return insert(value_type(k, mapped_type()), hash).first->second;
+	}
+
+	mapped_type& find_insert(key_type&& k, size_t hash) {
+		auto it = this->find(k, hash);
+		if (it != this->end())
+			return it->second;
+		return insert(value_type(std::move(k), mapped_type()), hash).first->second;
+	}
+
+	template<class K = key_type>
+	mapped_type& at(const key_arg<K>& k) {
+		auto it = this->find(k);
+		if (it == this->end())
+			this->throw_out_of_range();
+		return it->second;
+	}
+
+	template<class K = key_type>
+	const mapped_type& at(const key_arg<K>& k) const {
+		return const_cast<this_type*>(this)->at(k);
+	}
+};
+
+#pragma endregion hash_incremental_map
+
+#pragma region parallel
+
+/**
+ * Call fn(const value_type&) for every element of hash_set/hash_grow_set/hash_map/hash_grow_map, slot array split
+ * to nthreads (0 - hardware concurrency) ranges processed concurrently. Table must not be modified meanwhile, fn gets
+ * const references only and must be thread-safe itself. Order of calls unspecified.
+ */
+template<class Table, class F>
+void parallel_for_each(const Table& table, size_t nthreads, F fn)
+{
+    if (!table._size)
+        return;
+    hash_base::run_parallel_(table._capacity + 1, nthreads, [&](size_t, size_t first, size_t last) {
+        F f(fn);
+        table.template for_each_range_<Table>(first, last, f);
+    });
+}
+
+/**
+ * Parallel map-reduce over elements of hash_set/hash_grow_set/hash_map/hash_grow_map (see parallel_for_each).
+ * Every thread folds map(const value_type&) results of own range by reduce(T, T), partial results are folded to init
+ * in range order. reduce must be associative.
+ */
+template<class Table, class T, class Map, class Reduce>
+T parallel_reduce(const Table& table, size_t nthreads, T init, Map map, Reduce reduce)
+{
+    if (!table._size)
+        return init;
+
+    size_t n = table._capacity + 1;
+    std::vector<std::optional<T>> partial(hash_base::threads_count_(nthreads));
+
+    size_t parts = hash_base::run_parallel_(n, nthreads, [&](size_t part, size_t first, size_t last) {
+        std::optional<T> acc;
+        auto f = [&](const typename Table::value_type& v) {
+            if (acc)
+                acc = reduce(std::move(*acc), map(v));
+            else
+                acc.emplace(map(v));
+        };
+        table.template for_each_range_<Table>(first, last, f);
+        partial[part] = std::move(acc);
+    });
+
+    for (size_t i = 0; i < parts; ++i)
+        if (partial[i])
+            init = reduce(std::move(init), std::move(*partial[i]));
+    return init;
+}
+
+#pragma endregion parallel
+
 } //namespace hrd
@@ -30,6 +30,9 @@
 #include <stdexcept>
 #include <cstdint>
 #include <string.h> //memcpy
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 #ifdef _MSC_VER
 #  include <pmmintrin.h>
@@ -65,6 +68,27 @@ public:
         return hash_1<SIZE>(ptr);
     }
 
+    template<typename T>
+    struct is_transparent {
+        template<typename U> static std::true_type test(typename U::is_transparent*);
+        template<typename U> static std::false_type test(...);
+        static const bool value = decltype(test<T>(nullptr))::value;
+    };
+
+    struct lookup_any_ {
+        template<class K, class Key>
+        using type = K;
+    };
+
+    struct lookup_exact_ {
+        template<class K, class Key>
+        using type = Key;
+    };
+
+    //type<K, Key> is K if both Hasher and KeyEql declare is_transparent (lookup without temporary key), Key otherwise
+    template<class Hasher, class KeyEql>
+    using lookup_key = typename std::conditional<is_transparent<Hasher>::value && is_transparent<KeyEql>::value, lookup_any_, lookup_exact_>::type;
+
     template <class Key, class Hasher, class KeyEql>
     class
 #if defined(_MSC_VER) && _MSC_VER >= 1915
@@ -89,8 +113,10 @@ public:
             return *this;
         }
 
-        HRD_ALWAYS_INLINE size_t operator()(const Key& k) const { return static_cast<size_t>(hasher()(k)); }
-        HRD_ALWAYS_INLINE bool operator()(const Key& k1, const Key& k2) const { return keyeql()(k1, k2); }
+        template<typename K>
+        HRD_ALWAYS_INLINE size_t operator()(const K& k) const { return static_cast<size_t>(hasher()(k)); }
+        template<typename K1, typename K2>
+        HRD_ALWAYS_INLINE bool operator()(const K1& k1, const K2& k2) const { return keyeql()(k1, k2); }
 
         void swap(hash_eql& r) noexcept {
             std::swap(const_cast<Hasher&>(hasher()), const_cast<Hasher&>(r.hasher()));
@@ -259,12 +285,27 @@ HRD_ALWAYS_INLINE uint32_t hash_utils::hash_1<16>(const void* ptr) noexcept
     return hash32 ^ (hash32 >> 16);
 }
 
+#if __cplusplus >= 201703L
+template<>
+struct hash_utils::hash_<std::string_view> {
+    typedef void is_transparent;
+
+    HRD_ALWAYS_INLINE size_t operator()(std::string_view val) const noexcept {
+        return fnv_1a(val.data(), val.size());
+    }
+};
+
+//std::string, std::string_view and const char* of the same text hash equally: with std::equal_to<> std::string table is searched by any of them
+template<>
+struct hash_utils::hash_<std::string> : public hash_utils::hash_<std::string_view> {};
+#else
 template<>
 struct hash_utils::hash_<std::string> {
     HRD_ALWAYS_INLINE size_t operator()(const std::string& val) const noexcept {
         return fnv_1a(val.c_str(), val.size());
     }
 };
+#endif
 
 template<class Key, class T, class value, class Hash = hash_utils::hash_<Key>, class Pred = std::equal_to<Key>>
 class hash_base : public hash_utils, protected hash_utils::hash_eql<Key, Hash, Pred>
@@ -377,6 +418,10 @@ protected:
     typedef typename iterator_base<this_type>::iterator iterator;
     typedef typename iterator_base<this_type>::const_iterator const_iterator;
 
+    //key type of lookups, see hash_utils::lookup_key
+    template<class K>
+    using key_arg = typename lookup_key<Hash, Pred>::template type<K, key_type>;
+
     hash_base() noexcept {
         ctor_empty();
     }
@@ -471,18 +516,37 @@ public:
         }
     }
 
-    HRD_ALWAYS_INLINE iterator find(const key_type& k) noexcept {
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE iterator find(const key_arg<K>& k) noexcept {
         return iterator(find_(k), 0);
     }
 
-    HRD_ALWAYS_INLINE const_iterator find(const key_type& k) const noexcept {
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE const_iterator find(const key_arg<K>& k) const noexcept {
         return const_iterator(find_(k), 0);
     }
 
-    HRD_ALWAYS_INLINE size_type count(const key_type& k) const noexcept {
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type count(const key_arg<K>& k) const noexcept {
         return find_(k) != nullptr;
     }
 
+    //lookups by hash of k computed before, see insert(val, hash)
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE iterator find(const key_arg<K>& k, size_t hash) noexcept {
+        return iterator(find_(k, hash), 0);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE const_iterator find(const key_arg<K>& k, size_t hash) const noexcept {
+        return const_iterator(find_(k, hash), 0);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type count(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash) != nullptr;
+    }
+
     template <class P>
     HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(P&& val) {
         return insert_(std::forward<P>(val), std::false_type());
@@ -532,14 +596,25 @@ public:
         return ret;
     }
 
+    //exact match for iterator argument, erase(key_arg<K>) of transparent table takes it otherwise
+    HRD_ALWAYS_INLINE iterator erase(iterator it) noexcept {
+        return erase(const_iterator(it));
+    }
+
     /*! Can invalidate iterators.
     * \params k - Key of the element to be erased
     * \return 1 - if element erased and zero otherwise
     */
-    HRD_ALWAYS_INLINE size_type erase(const key_type& k) noexcept
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type erase(const key_arg<K>& k) noexcept {
+        return erase(k, hash_pred::operator()(k));
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type erase(const key_arg<K>& k, size_t hash) noexcept
     {
         auto ee = (storage_type*)_elements;
-        const uint32_t mark = make_mark(hash_pred::operator()(k));
+        const uint32_t mark = make_mark(hash);
 
         for (size_t i = mark;;)
         {
@@ -901,11 +976,17 @@ protected:
 
     //all needed space should be allocated before
     template<typename V>
-    std::pair<iterator, bool> insert_(V&& val, std::true_type)
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert_(V&& val, std::true_type) {
+        return insert_(std::forward<V>(val), hash_pred::operator()(get_key(val)), std::true_type());
+    }
+
+    //all needed space should be allocated before, h - hash of val key
+    template<typename V>
+    std::pair<iterator, bool> insert_(V&& val, size_t h, std::true_type)
     {
         storage_type* empty_spot = nullptr;
         uint32_t deleted_mark = DELETED_MARK;
-        const uint32_t mark = make_mark(hash_pred::operator()(get_key(val)));
+        const uint32_t mark = make_mark(h);
 
         for (size_t i = mark;;)
         {
@@ -947,9 +1028,27 @@ protected:
         return insert_(std::forward<V>(val), std::true_type());
     }
 
-    HRD_ALWAYS_INLINE storage_type* find_(const key_type& k) const noexcept
+    //probe available size, h - hash of val key
+    template<typename V>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert_(V&& val, size_t h, std::false_type)
     {
-        const uint32_t mark = make_mark(hash_pred::operator()(k));
+        size_t used = _erased + _size;
+        if (HRD_UNLIKELY(_capacity - used <= used))
+            resize_pow2(2 * (_capacity + 1));
+
+        return insert_(std::forward<V>(val), h, std::true_type());
+    }
+
+    template<typename K>
+    HRD_ALWAYS_INLINE storage_type* find_(const K& k) const noexcept {
+        return find_(k, hash_pred::operator()(k));
+    }
+
+    //h - hash of k
+    template<typename K>
+    HRD_ALWAYS_INLINE storage_type* find_(const K& k, size_t h) const noexcept
+    {
+        const uint32_t mark = make_mark(h);
         for (size_t i = mark;;)
         {
             i &= _capacity;
@@ -1108,6 +1207,17 @@ public:
         return super_type::insert_(std::forward<K>(val), std::false_type());
     }
 
+    /*! Can invalidate iterators.
+    * \params hash - hash of val computed before by hasher, the same key looked up in several tables is hashed once
+    */
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(const key_type& val, size_t hash) {
+        return super_type::insert_(val, hash, std::false_type());
+    }
+
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(key_type&& val, size_t hash) {
+        return super_type::insert_(std::move(val), hash, std::false_type());
+    }
+
     HRD_ALWAYS_INLINE hash_set& operator=(const hash_set& r) {
         this_type(r).swap(*this);
         return *this;
@@ -1190,6 +1300,19 @@ public:
     HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
         return super_type::emplace_(std::forward<K>(key), std::forward<Args>(args)...);
     }
+
+    /*! Can invalidate iterators. Probes first: mapped value constructed from args only if k is absent, args untouched otherwise.
+    * \return iterator to the element with key k and true if inserted
+    */
+    template<class... Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+        return super_type::emplace_(k, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+        return super_type::emplace_(std::move(k), std::forward<Args>(args)...);
+    }
 #else
     template<class Args>
     HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace(const Key& key, Args&& args) {
@@ -1202,6 +1325,36 @@ public:
     }
 #endif //C++-11 support
 
+    /*! Can invalidate iterators. obj assigned to mapped value of present k, inserted with k (constructed from obj) otherwise.
+    * \return iterator to the element with key k and true if inserted
+    */
+    template<class M>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+        std::pair<iterator, bool> ret = super_type::emplace_(k, std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+
+    template<class M>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+        std::pair<iterator, bool> ret = super_type::emplace_(std::move(k), std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+
+    /*! Can invalidate iterators.
+    * \params hash - hash of val.first computed before by hasher, the same key looked up in several tables is hashed once
+    */
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(const value_type& val, size_t hash) {
+        return super_type::insert_(val, hash, std::false_type());
+    }
+
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(value_type&& val, size_t hash) {
+        return super_type::insert_(std::move(val), hash, std::false_type());
+    }
+
     HRD_ALWAYS_INLINE hash_map& operator=(const hash_map& r) {
         this_type(r).swap(*this);
         return *this;
@@ -1213,16 +1366,25 @@ public:
     }
 
     HRD_ALWAYS_INLINE mapped_type& operator[](const key_type& k) {
-        return find_insert(k);
+        return find_insert_(k, super_type::hash_pred::operator()(k));
     }
 
     HRD_ALWAYS_INLINE mapped_type& operator[](key_type&& k) {
-        return find_insert(std::move(k));
+        return find_insert_(std::move(k), super_type::hash_pred::operator()(k));
+    }
+
+    //operator[] by hash of k computed before, see insert(val, hash)
+    HRD_ALWAYS_INLINE mapped_type& find_insert(const key_type& k, size_t hash) {
+        return find_insert_(k, hash);
+    }
+
+    HRD_ALWAYS_INLINE mapped_type& find_insert(key_type&& k, size_t hash) {
+        return find_insert_(std::move(k), hash);
     }
 
 private:
     template<typename V>
-    HRD_ALWAYS_INLINE mapped_type& find_insert(V&& k)
+    HRD_ALWAYS_INLINE mapped_type& find_insert_(V&& k, size_t h)
     {
         size_type used = this->_erased + this->_size;
         if (HRD_UNLIKELY(this->_capacity - used <= used))
@@ -1230,7 +1392,7 @@ private:
 
         storage_type* empty_spot = nullptr;
         uint32_t deleted_mark = hash_utils::DELETED_MARK;
-        const uint32_t mark = hash_utils::make_mark(super_type::hash_pred::operator()(k));
+        const uint32_t mark = super_type::make_mark(h);
 
         for (size_t i = mark;;)
         {
@@ -0,0 +1,792 @@
+#pragma once
+
+// Concurrent hashtables based on hrd::hash_map (hash_set.h), C++17 and up
+// version 1.0.0
+//
+// https://github.com/hordi/hash
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018-2026 Yurii Hordiienko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "hash_set.h"
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace hrd {
+
+#pragma region concurrent_hash_map
+
+///Keys sharded over SHARDS independently locked hash_map-s, shard chosen by upper bits of (multiplied) key hash.
+///Elements are accessed by callbacks only (called under shard lock, so they must not call the same table),
+///references never escape the lock: visit/cvisit, insert_or_visit, erase_if.
+template<class Key, class T, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>, size_t SHARDS = 64>
+class concurrent_hash_map
+{
+    static_assert(SHARDS && !(SHARDS & (SHARDS - 1)), "SHARDS must be power of 2");
+
+public:
+    using this_type   = concurrent_hash_map<Key, T, Hash, Pred, SHARDS>;
+    using map_type    = hash_map<Key, T, Hash, Pred>;
+
+    //key type of lookups, see hash_base::lookup_key
+    template<class K>
+    using key_arg = typename map_type::template key_arg<K>;
+    using key_type    = Key;
+    using mapped_type = T;
+    using hasher_type = Hash;
+    using keyeql_type = Pred;
+    using value_type  = typename map_type::value_type;
+    using size_type   = typename map_type::size_type;
+
+    concurrent_hash_map() = default;
+
+    concurrent_hash_map(size_type hint_size, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) : _hash(hf) {
+        for (auto& s : _shards)
+            s.map = map_type(hint_size / SHARDS, hf, eql);
+    }
+
+    concurrent_hash_map(const concurrent_hash_map&) = delete;
+    concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+    //not synchronized with concurrent modifications, exact only if no one happens
+    size_type size() const {
+        size_type cnt = 0;
+        for (auto& s : _shards) {
+            std::shared_lock<std::shared_mutex> lock(s.mtx);
+            cnt += s.map.size();
+        }
+        return cnt;
+    }
+
+    bool empty() const { return !size(); }
+
+    void reserve(size_type hint) {
+        for (auto& s : _shards) {
+            std::unique_lock<std::shared_mutex> lock(s.mtx);
+            s.map.reserve(hint / SHARDS);
+        }
+    }
+
+    void clear() {
+        for (auto& s : _shards) {
+            std::unique_lock<std::shared_mutex> lock(s.mtx);
+            s.map.clear();
+        }
+    }
+
+    /*! \return true if inserted, false if equal key present already */
+    bool insert(const value_type& val) {
+        return insert(val, _hash(val.first));
+    }
+
+    bool insert(value_type&& val) {
+        return insert(std::move(val), _hash(val.first));
+    }
+
+    /*! Key hash computed before by hasher_type: picks the shard and is passed to the shard map, no hashing inside.
+    * Same for the rest of (k, hash) calls.
+    */
+    bool insert(const value_type& val, size_t hash) {
+        auto& s = shard_(hash);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        return s.map.insert(val, hash).second;
+    }
+
+    bool insert(value_type&& val, size_t hash) {
+        auto& s = shard_(hash);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        return s.map.insert(std::move(val), hash).second;
+    }
+
+    template<class K, class... Args>
+    bool emplace(K&& key, Args&&... args) {
+        size_t h = _hash(key);
+        auto& s = shard_(h);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        return s.map.emplace_hashed_(h, std::forward<K>(key), std::forward<Args>(args)...).second;
+    }
+
+    /*! Mapped value constructed from args only if k is absent.
+    * \return true if inserted
+    */
+    template<class... Args>
+    bool try_emplace(const key_type& k, Args&&... args) {
+        size_t h = _hash(k);
+        auto& s = shard_(h);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        return s.map.emplace_hashed_(h, k, std::forward<Args>(args)...).second;
+    }
+
+    template<class... Args>
+    bool try_emplace(key_type&& k, Args&&... args) {
+        size_t h = _hash(k);
+        auto& s = shard_(h);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        return s.map.emplace_hashed_(h, std::move(k), std::forward<Args>(args)...).second;
+    }
+
+    /*! obj assigned to mapped value of present k under exclusive shard lock, inserted with k otherwise.
+    * \return true if inserted
+    */
+    template<class M>
+    bool insert_or_assign(const key_type& k, M&& obj) {
+        size_t h = _hash(k);
+        auto& s = shard_(h);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        auto ret = s.map.emplace_hashed_(h, k, std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret.second;
+    }
+
+    template<class M>
+    bool insert_or_assign(key_type&& k, M&& obj) {
+        size_t h = _hash(k);
+        auto& s = shard_(h);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        auto ret = s.map.emplace_hashed_(h, std::move(k), std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret.second;
+    }
+
+    /*! Insert val if its key is absent, f(value_type&) called for the present element otherwise.
+    * \return true if inserted
+    */
+    template<class F>
+    bool insert_or_visit(const value_type& val, F f) {
+        return insert_or_visit(val, _hash(val.first), f);
+    }
+
+    template<class F>
+    bool insert_or_visit(value_type&& val, F f) {
+        return insert_or_visit(std::move(val), _hash(val.first), f);
+    }
+
+    template<class F>
+    bool insert_or_visit(const value_type& val, size_t hash, F f) {
+        auto& s = shard_(hash);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        auto pr = s.map.insert(val, hash);
+        if (!pr.second)
+            f(*pr.first);
+        return pr.second;
+    }
+
+    template<class F>
+    bool insert_or_visit(value_type&& val, size_t hash, F f) {
+        auto& s = shard_(hash);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        auto pr = s.map.insert(std::move(val), hash);
+        if (!pr.second)
+            f(*pr.first);
+        return pr.second;
+    }
+
+    /*! f(value_type&) called for the element with key k under exclusive shard lock.
+    * \return number of visited elements (0 or 1)
+    */
+    template<class K = key_type, class F>
+    size_type visit(const key_arg<K>& k, F f) {
+        return visit(k, _hash(k), f);
+    }
+
+    template<class K = key_type, class F>
+    size_type visit(const key_arg<K>& k, size_t hash, F f) {
+        auto& s = shard_(hash);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        auto it = s.map.find(k, hash);
+        if (it == s.map.end())
+            return 0;
+        f(*it);
+        return 1;
+    }
+
+    /*! f(const value_type&) called for the element with key k under shared shard lock (concurrent readers allowed).
+    * \return number of visited elements (0 or 1)
+    */
+    template<class K = key_type, class F>
+    size_type cvisit(const key_arg<K>& k, F f) const {
+        return cvisit(k, _hash(k), f);
+    }
+
+    template<class K = key_type, class F>
+    size_type cvisit(const key_arg<K>& k, size_t hash, F f) const {
+        auto& s = shard_(hash);
+        std::shared_lock<std::shared_mutex> lock(s.mtx);
+        auto it = s.map.find(k, hash);
+        if (it == s.map.end())
+            return 0;
+        f(*it);
+        return 1;
+    }
+
+    template<class K = key_type, class F>
+    size_type visit(const key_arg<K>& k, F f) const {
+        return cvisit(k, f);
+    }
+
+    template<class K = key_type, class F>
+    size_type visit(const key_arg<K>& k, size_t hash, F f) const {
+        return cvisit(k, hash, f);
+    }
+
+    //f(value_type&) for every element, shards locked one by one
+    template<class F>
+    size_type visit_all(F f) {
+        size_type cnt = 0;
+        for (auto& s : _shards) {
+            std::unique_lock<std::shared_mutex> lock(s.mtx);
+            for (auto& v : s.map)
+                f(v);
+            cnt += s.map.size();
+        }
+        return cnt;
+    }
+
+    template<class F>
+    size_type cvisit_all(F f) const {
+        size_type cnt = 0;
+        for (auto& s : _shards) {
+            std::shared_lock<std::shared_mutex> lock(s.mtx);
+            for (auto& v : s.map)
+                f(v);
+            cnt += s.map.size();
+        }
+        return cnt;
+    }
+
+    template<class K = key_type>
+    bool contains(const key_arg<K>& k) const {
+        return contains(k, _hash(k));
+    }
+
+    template<class K = key_type>
+    bool contains(const key_arg<K>& k, size_t hash) const {
+        auto& s = shard_(hash);
+        std::shared_lock<std::shared_mutex> lock(s.mtx);
+        return s.map.contains(k, hash);
+    }
+
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k) const {
+        return contains(k);
+    }
+
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k, size_t hash) const {
+        return contains(k, hash);
+    }
+
+    template<class K = key_type>
+    size_type erase(const key_arg<K>& k) {
+        return erase(k, _hash(k));
+    }
+
+    template<class K = key_type>
+    size_type erase(const key_arg<K>& k, size_t hash) {
+        auto& s = shard_(hash);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        return s.map.erase(k, hash);
+    }
+
+    /*! Erase the element with key k if f(value_type&) returns true.
+    * \return 1 - if element erased and zero otherwise
+    */
+    template<class K = key_type, class F>
+    size_type erase_if(const key_arg<K>& k, F f) {
+        return erase_if(k, _hash(k), f);
+    }
+
+    template<class K = key_type, class F>
+    size_type erase_if(const key_arg<K>& k, size_t hash, F f) {
+        auto& s = shard_(hash);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        auto it = s.map.find(k, hash);
+        if (it == s.map.end() || !f(*it))
+            return 0;
+        s.map.erase(it);
+        return 1;
+    }
+
+    /*! Erase all the elements f(value_type&) returns true for, shards locked one by one.
+    * \return number of erased elements
+    */
+    template<class F>
+    size_type erase_if(F f) {
+        size_type cnt = 0;
+        for (auto& s : _shards) {
+            std::unique_lock<std::shared_mutex> lock(s.mtx);
+            for (auto it = s.map.begin(); it != s.map.end();) {
+                if (f(*it)) {
+                    it = s.map.erase(it);
+                    cnt++;
+                }
+                else
+                    ++it;
+            }
+        }
+        return cnt;
+    }
+
+private:
+    //own cache line for every shard, no false sharing of locks
+    struct alignas(64) shard {
+        mutable std::shared_mutex mtx;
+        map_type map;
+    };
+
+    //upper bits of hash multiplied by 2^64/phi: depends on all the hash bits (32-bit hashes too),
+    //independent of low bits used by map index
+    HRD_ALWAYS_INLINE static size_t shard_idx_(size_t h) noexcept {
+        if constexpr (SHARDS == 1)
+            return 0;
+        else
+            return (size_t)(((uint64_t)h * 0x9e3779b97f4a7c15ull) >> (64 - log2_(SHARDS)));
+    }
+
+    constexpr static unsigned log2_(size_t v) noexcept {
+        return (v > 1) ? 1 + log2_(v >> 1) : 0;
+    }
+
+    //h - key hash
+    HRD_ALWAYS_INLINE shard& shard_(size_t h) noexcept { return _shards[shard_idx_(h)]; }
+    HRD_ALWAYS_INLINE const shard& shard_(size_t h) const noexcept { return _shards[shard_idx_(h)]; }
+
+    shard _shards[SHARDS];
+    hasher_type _hash;
+};
+
+#pragma endregion concurrent_hash_map
+
+#pragma region concurrent_grow_base
+
+struct concurrent_set_key_getter {
+    template<class V>
+    static const V& get_key(const V& v) noexcept { return v; }
+};
+
+struct concurrent_map_key_getter {
+    template<class V>
+    static const typename V::first_type& get_key(const V& v) noexcept { return v.first; }
+};
+
+///Grow-only table for one writer thread and any number of lock-free reader threads.
+///Nothing is erased or modified in place: writer constructs an element and publishes its mark by release store,
+///readers check marks by acquire load. Resize copies elements to a new block published by atomic pointer, the old block
+///is freed by the writer later, when all readers which could see it have left (two epochs over striped reader counters).
+///Non-const calls must be done from the writer thread only.
+template<class Key, class ValueType, class Hash, class Pred, class KeyGetter>
+class concurrent_grow_base
+{
+public:
+    using key_type    = Key;
+    using value_type  = ValueType;
+    using size_type   = size_t;
+    using hasher_type = Hash;
+    using keyeql_type = Pred;
+
+    //key type of lookups, see hash_base::lookup_key
+    template<class K>
+    using key_arg = typename hash_base::lookup_key<Hash, Pred>::template type<K, key_type>;
+
+    constexpr static const float LOAD_FACTOR = 0.65f;
+
+    concurrent_grow_base(size_type hint_size = 0, const hasher_type& hf = hasher_type(), const keyeql_type& eql = keyeql_type()) :
+        _hash(hf), _eql(eql)
+    {
+        _block.store(alloc_block_(calc_pow2_(hint_size)), std::memory_order_relaxed);
+    }
+
+    concurrent_grow_base(const concurrent_grow_base&) = delete;
+    concurrent_grow_base& operator=(const concurrent_grow_base&) = delete;
+
+    //no readers allowed at this point
+    ~concurrent_grow_base() {
+        free_block_(_block.load(std::memory_order_relaxed));
+        for (auto& r : _retired)
+            free_block_(r.ptr);
+    }
+
+    size_type size() const noexcept { return _size.load(std::memory_order_relaxed); }
+    bool empty() const noexcept { return !size(); }
+
+    /*! Any thread. f(const value_type&) called for the element with key k, storage can't be freed while f works.
+    * \return true if found
+    */
+    template<class K = key_type, class F>
+    bool visit(const key_arg<K>& k, F f) const {
+        return visit(k, _hash(k), f);
+    }
+
+    //any thread, hash - hash of k computed before by hasher_type
+    template<class K = key_type, class F>
+    bool visit(const key_arg<K>& k, size_t hash, F f) const {
+        reader_guard guard(*this);
+        if (auto* p = find_(_block.load(std::memory_order_seq_cst), k, hash)) {
+            f(*p);
+            return true;
+        }
+        return false;
+    }
+
+    //any thread
+    template<class K = key_type>
+    bool contains(const key_arg<K>& k) const {
+        return visit(k, [](const ValueType&) {});
+    }
+
+    template<class K = key_type>
+    bool contains(const key_arg<K>& k, size_t hash) const {
+        return visit(k, hash, [](const ValueType&) {});
+    }
+
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k) const {
+        return contains(k);
+    }
+
+    template<class K = key_type>
+    size_type count(const key_arg<K>& k, size_t hash) const {
+        return contains(k, hash);
+    }
+
+    //writer thread only
+    void reserve(size_type hint) {
+        size_t pow2 = calc_pow2_(hint);
+        if (pow2 > _block.load(std::memory_order_relaxed)->mask + 1)
+            grow_(pow2);
+    }
+
+protected:
+    //writer thread only, construct(void*) places new element if k is absent
+    template<typename F>
+    HRD_ALWAYS_INLINE bool insert_(const key_type& k, F construct) {
+        return insert_(k, _hash(k), construct);
+    }
+
+    //h - hash of k
+    template<typename F>
+    bool insert_(const key_type& k, size_t h, F construct)
+    {
+        if (HRD_UNLIKELY(!_retired.empty()))
+            reclaim_();
+
+        block* b = _block.load(std::memory_order_relaxed);
+        const uint8_t mark = make_mark_(h);
+
+        size_t i = h & b->mask;
+        for (uint8_t m; (m = b->marks()[i].load(std::memory_order_relaxed)) != 0; i = (i + 1) & b->mask) {
+            if (m == mark && _eql(KeyGetter::get_key(b->slots()[i]), k))
+                return false;
+        }
+
+        if (HRD_UNLIKELY(_size.load(std::memory_order_relaxed) >= b->gap)) {
+            b = grow_(2 * (b->mask + 1));
+            i = empty_pos_(b, h);
+        }
+
+        construct((void*)(b->slots() + i));
+        b->marks()[i].store(mark, std::memory_order_release);
+        _size.store(_size.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    struct block
+    {
+        size_t mask; //capacity - 1
+        size_t gap;  //max elements before resize
+
+        constexpr static size_t MARKS_OFFSET = (sizeof(size_t) * 2 + alignof(ValueType) - 1) & ~(alignof(ValueType) - 1);
+
+        std::atomic<uint8_t>* marks() const noexcept {
+            return (std::atomic<uint8_t>*)((char*)this + MARKS_OFFSET);
+        }
+        ValueType* slots() const noexcept {
+            return (ValueType*)((char*)this + MARKS_OFFSET + marks_size(mask));
+        }
+        constexpr static size_t marks_size(size_t mask) noexcept {
+            return (mask + 1 + alignof(ValueType) - 1) & ~(alignof(ValueType) - 1);
+        }
+    };
+
+    struct retired_block {
+        block* ptr;
+        uint64_t epoch;
+    };
+
+    //readers of one stripe counted by parity of the epoch they entered at, own cache line each
+    struct alignas(64) reader_stripe {
+        std::atomic<size_t> cnt[2] = {};
+    };
+    constexpr static size_t READER_STRIPES = 64;
+
+    class reader_guard
+    {
+    public:
+        explicit reader_guard(const concurrent_grow_base& ref) noexcept {
+            auto& stripe = ref._readers[stripe_idx_()];
+            for (;;) {
+                uint64_t e = ref._epoch.load(std::memory_order_seq_cst);
+                _cnt = &stripe.cnt[e & 1];
+                _cnt->fetch_add(1, std::memory_order_seq_cst);
+                if (HRD_LIKELY(ref._epoch.load(std::memory_order_seq_cst) == e))
+                    break;
+                _cnt->fetch_sub(1, std::memory_order_seq_cst); //epoch switched meanwhile, enter the new one
+            }
+        }
+        ~reader_guard() { _cnt->fetch_sub(1, std::memory_order_release); }
+
+    private:
+        static size_t stripe_idx_() noexcept {
+            static std::atomic<size_t> next{ 0 };
+            thread_local size_t idx = next.fetch_add(1, std::memory_order_relaxed) & (READER_STRIPES - 1);
+            return idx;
+        }
+
+        std::atomic<size_t>* _cnt;
+    };
+
+    HRD_ALWAYS_INLINE static uint8_t make_mark_(size_t h) noexcept {
+        return (uint8_t)(0x80 | (((uint32_t)h ^ (uint32_t)((uint64_t)h >> 32)) >> 25));
+    }
+
+    static size_t calc_pow2_(size_t hint) noexcept {
+        size_t pow2 = 8;
+        while (hint >= (size_t)(pow2 * LOAD_FACTOR))
+            pow2 <<= 1;
+        return pow2;
+    }
+
+    template<typename K>
+    HRD_ALWAYS_INLINE const ValueType* find_(const block* b, const K& k, size_t h) const noexcept
+    {
+        const uint8_t mark = make_mark_(h);
+        for (size_t i = h & b->mask;; i = (i + 1) & b->mask) {
+            uint8_t m = b->marks()[i].load(std::memory_order_acquire);
+            if (!m)
+                return nullptr;
+            if (m == mark && _eql(KeyGetter::get_key(b->slots()[i]), k))
+                return b->slots() + i;
+        }
+    }
+
+    HRD_ALWAYS_INLINE static size_t empty_pos_(const block* b, size_t h) noexcept {
+        size_t i = h & b->mask;
+        while (b->marks()[i].load(std::memory_order_relaxed))
+            i = (i + 1) & b->mask;
+        return i;
+    }
+
+    static block* alloc_block_(size_t pow2)
+    {
+        size_t mask = pow2 - 1;
+        auto* b = (block*)malloc(block::MARKS_OFFSET + block::marks_size(mask) + pow2 * sizeof(ValueType));
+        if (HRD_UNLIKELY(!b))
+            throw std::bad_alloc();
+        b->mask = mask;
+        b->gap = (size_t)(pow2 * LOAD_FACTOR);
+        for (size_t i = 0; i != pow2; ++i)
+            new ((void*)(b->marks() + i)) std::atomic<uint8_t>(0);
+        return b;
+    }
+
+    static void free_block_(block* b) noexcept
+    {
+        if (!std::is_trivially_destructible<ValueType>::value) {
+            for (size_t i = 0; i <= b->mask; ++i)
+                if (b->marks()[i].load(std::memory_order_relaxed))
+                    b->slots()[i].~ValueType();
+        }
+        free(b);
+    }
+
+    //copy (readers may still use the old block) to new storage, publish it and retire the old one
+    block* grow_(size_t pow2)
+    {
+        block* old = _block.load(std::memory_order_relaxed);
+        _retired.reserve(_retired.size() + 1); //nothing throws after the publish: old block is always retired
+        block* b = alloc_block_(pow2);
+
+        size_t i = 0;
+        try {
+            for (; i <= old->mask; ++i) {
+                if (uint8_t m = old->marks()[i].load(std::memory_order_relaxed)) {
+                    auto& v = old->slots()[i];
+                    size_t pos = empty_pos_(b, _hash(KeyGetter::get_key(v)));
+                    new ((void*)(b->slots() + pos)) ValueType(v);
+                    b->marks()[pos].store(m, std::memory_order_relaxed);
+                }
+            }
+        }
+        catch (...) {
+            free_block_(b);
+            throw;
+        }
+
+        _block.store(b, std::memory_order_seq_cst);
+        _retired.push_back(retired_block{ old, _epoch.load(std::memory_order_relaxed) });
+        reclaim_();
+        return b;
+    }
+
+    bool drained_(size_t parity) const noexcept {
+        for (auto& s : _readers)
+            if (s.cnt[parity].load(std::memory_order_seq_cst))
+                return false;
+        return true;
+    }
+
+    /** Active readers entered at epoch "e" or "e - 1" only: next epoch started when readers of "e - 1" left.
+     * Block retired at epoch "r" freed when "r + 2" started or "r + 1" started and readers of "r" left.
+     */
+    void reclaim_() noexcept
+    {
+        uint64_t e = _epoch.load(std::memory_order_relaxed);
+        if (_retired.back().epoch == e && drained_((e + 1) & 1))
+            _epoch.store(++e, std::memory_order_seq_cst);
+
+        int prev_drained = -1; //lazy
+        size_t n = 0;
+        for (auto& r : _retired) {
+            bool can_free = (r.epoch + 2 <= e);
+            if (!can_free && r.epoch + 1 == e) {
+                if (prev_drained < 0)
+                    prev_drained = drained_(r.epoch & 1);
+                can_free = !!prev_drained;
+            }
+            if (can_free)
+                free_block_(r.ptr);
+            else
+                _retired[n++] = r;
+        }
+        _retired.resize(n);
+    }
+
+    std::atomic<block*> _block;
+    std::atomic<size_t> _size{ 0 };
+    std::atomic<uint64_t> _epoch{ 2 };
+    mutable reader_stripe _readers[READER_STRIPES];
+    std::vector<retired_block> _retired;
+    hasher_type _hash;
+    keyeql_type _eql;
+};
+
+#pragma endregion concurrent_grow_base
+
+#pragma region hash_grow_set_concurrent
+
+///hash_grow_set for one writer and lock-free readers (see concurrent_grow_base): contains()/visit() from any thread.
+template<class Key, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>>
+class hash_grow_set_concurrent : public concurrent_grow_base<Key, Key, Hash, Pred, concurrent_set_key_getter>
+{
+    using base_type = concurrent_grow_base<Key, Key, Hash, Pred, concurrent_set_key_getter>;
+
+public:
+    using base_type::base_type;
+
+    //writer thread only, return true if inserted
+    bool insert(const Key& k) {
+        return this->insert_(k, [&](void* p) { new (p) Key(k); });
+    }
+
+    bool insert(Key&& k) {
+        return this->insert_(k, [&](void* p) { new (p) Key(std::move(k)); });
+    }
+
+    //writer thread only, hash - hash of k computed before by hasher_type
+    bool insert(const Key& k, size_t hash) {
+        return this->insert_(k, hash, [&](void* p) { new (p) Key(k); });
+    }
+
+    bool insert(Key&& k, size_t hash) {
+        return this->insert_(k, hash, [&](void* p) { new (p) Key(std::move(k)); });
+    }
+
+    template<class... Args>
+    bool emplace(Args&&... args) {
+        Key k(std::forward<Args>(args)...);
+        return insert(std::move(k));
+    }
+};
+
+#pragma endregion hash_grow_set_concurrent
+
+#pragma region hash_grow_map_concurrent
+
+///hash_grow_map for one writer and lock-free readers (see concurrent_grow_base): contains()/visit() from any thread.
+///Values are immutable after insert since readers access them without locks.
+template<class Key, class T, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>>
+class hash_grow_map_concurrent : public concurrent_grow_base<Key, std::pair<const Key, T>, Hash, Pred, concurrent_map_key_getter>
+{
+    using base_type = concurrent_grow_base<Key, std::pair<const Key, T>, Hash, Pred, concurrent_map_key_getter>;
+
+public:
+    using mapped_type = T;
+    using value_type  = typename base_type::value_type;
+
+    using base_type::base_type;
+
+    //writer thread only, return true if inserted
+    bool insert(const value_type& val) {
+        return this->insert_(val.first, [&](void* p) { new (p) value_type(val); });
+    }
+
+    bool insert(value_type&& val) {
+        return this->insert_(val.first, [&](void* p) { new (p) value_type(std::move(val)); });
+    }
+
+    //writer thread only, hash - hash of val.first computed before by hasher_type
+    bool insert(const value_type& val, size_t hash) {
+        return this->insert_(val.first, hash, [&](void* p) { new (p) value_type(val); });
+    }
+
+    bool insert(value_type&& val, size_t hash) {
+        return this->insert_(val.first, hash, [&](void* p) { new (p) value_type(std::move(val)); });
+    }
+
+    template<class K, class... Args>
+    bool emplace(K&& k, Args&&... args) {
+        const Key& key = k;
+        return this->insert_(key, [&](void* p) {
+            new (p) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(k)), std::forward_as_tuple(std::forward<Args>(args)...));
+        });
+    }
+
+    //writer thread only, mapped value constructed from args only if k is absent (no insert_or_assign: published elements are never modified)
+    template<class... Args>
+    bool try_emplace(const Key& k, Args&&... args) {
+        return emplace(k, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    bool try_emplace(Key&& k, Args&&... args) {
+        return emplace(std::move(k), std::forward<Args>(args)...);
+    }
+};
+
+#pragma endregion hash_grow_map_concurrent
+
+} //namespace hrd
@@ -0,0 +1,165 @@
+#pragma once
+
+// Huge page and NUMA placement storage policy for hrd flat tables (hash_set.h), C++17 and up
+// version 1.0.0
+//
+// https://github.com/hordi/hash
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018-2026 Yurii Hordiienko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "hash_set.h"
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  ifdef __linux__
+#    include <sys/syscall.h>
+#  endif
+#endif
+
+//storage blocks less than it (bytes) are taken from malloc by hrd::huge_page_allocator
+#ifndef HRD_HUGE_PAGE_MIN
+#  define HRD_HUGE_PAGE_MIN (32 << 20)
+#endif
+
+namespace hrd {
+
+#pragma region huge_page_allocator
+
+/**
+ * Storage policy (see malloc_allocator) for big tables: blocks of "min_bytes" and more are mapped 2MB-aligned and marked MADV_HUGEPAGE (Linux),
+ * so random lookups over multi-GB table hit TLB instead of walking 4K page tables. Pages optionally placed on NUMA "nodes" (bit per node)
+ * before first touch: INTERLEAVE spreads them round-robin, BIND/PREFERRED keep them on given nodes.
+ * Linux only for NUMA (mbind), on Windows PREFERRED/BIND use lowest node of the mask, INTERLEAVE is ignored.
+ * On Windows blocks are MEM_LARGE_PAGES (aligned to large page) if the process enabled SeLockMemoryPrivilege ("Lock pages in memory"),
+ * regular 64K-aligned 4K pages otherwise.
+ * Usage: hrd::hash_map<K, V, hrd::hash_base::hash_<K>, std::equal_to<K>, hrd::huge_page_allocator> m(hrd::huge_page_allocator(hrd::huge_page_allocator::INTERLEAVE, 0x3));
+ */
+class huge_page_allocator
+{
+public:
+    enum numa_policy : int { DEFAULT = 0, PREFERRED = 1, BIND = 2, INTERLEAVE = 3 }; //values of Linux MPOL_*
+
+    constexpr static size_t HUGE_PAGE = size_t(2) << 20;
+
+    huge_page_allocator(numa_policy policy = DEFAULT, uint64_t nodes = 0, size_t min_bytes = HRD_HUGE_PAGE_MIN) noexcept :
+        _nodes(policy != DEFAULT ? nodes : 0), _min_bytes(min_bytes), _policy(nodes ? policy : DEFAULT)
+    {}
+
+    void* allocate(size_t bytes) noexcept
+    {
+        if (bytes < _min_bytes)
+            return malloc(bytes);
+
+        size_t len = round_(bytes);
+#ifdef _WIN32
+        //large pages fail without SeLockMemoryPrivilege enabled in the process token: regular pages then
+        static const size_t large = GetLargePageMinimum();
+        void* p = nullptr;
+        if (large && !(len % large))
+            p = virtual_alloc_(len, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES);
+        if (!p)
+            p = virtual_alloc_(len, MEM_RESERVE | MEM_COMMIT);
+        return p;
+#else
+        //over-map by one huge page and trim both ends to get 2MB-aligned block
+        void* map = mmap(nullptr, len + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (map == MAP_FAILED)
+            return nullptr;
+
+        auto* first = static_cast<char*>(map);
+        auto* p = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(first) + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1));
+        if (p != first)
+            munmap(first, p - first);
+        if (size_t tail = HUGE_PAGE - (p - first))
+            munmap(p + len, tail);
+
+#  ifdef MADV_HUGEPAGE
+        madvise(p, len, MADV_HUGEPAGE); //THP may be disabled system-wide, block is still usable
+#  endif
+#  ifdef __linux__
+        if (_policy != DEFAULT) {
+            unsigned long mask = (unsigned long)_nodes;
+            if (syscall(SYS_mbind, p, len, (int)_policy, &mask, sizeof(mask) * 8 + 1, 0) != 0 && _policy == BIND) {
+                munmap(p, len);
+                return nullptr;
+            }
+        }
+#  endif
+        return p;
+#endif
+    }
+
+    void deallocate(void* p, size_t bytes) noexcept
+    {
+        if (bytes < _min_bytes)
+            free(p);
+        else {
+#ifdef _WIN32
+            VirtualFree(p, 0, MEM_RELEASE);
+#else
+            munmap(p, round_(bytes));
+#endif
+        }
+    }
+
+    numa_policy policy() const noexcept { return _policy; }
+    uint64_t nodes() const noexcept { return _nodes; }
+    size_t min_bytes() const noexcept { return _min_bytes; }
+
+private:
+    static size_t round_(size_t bytes) noexcept {
+        return (bytes + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+    }
+
+#ifdef _WIN32
+    void* virtual_alloc_(size_t len, DWORD type) const noexcept {
+        return (_policy == PREFERRED || _policy == BIND) ?
+            VirtualAllocExNuma(GetCurrentProcess(), nullptr, len, type, PAGE_READWRITE, (DWORD)ctz(_nodes)) :
+            VirtualAlloc(nullptr, len, type, PAGE_READWRITE);
+    }
+#endif
+
+    static unsigned long ctz(uint64_t v) noexcept {
+#ifdef _MSC_VER
+        unsigned long r;
+        _BitScanForward64(&r, v);
+        return r;
+#else
+        return (unsigned long)__builtin_ctzll(v);
+#endif
+    }
+
+    uint64_t    _nodes;
+    size_t      _min_bytes;
+    numa_policy _policy;
+};
+
+#pragma endregion huge_page_allocator
+
+} //namespace hrd
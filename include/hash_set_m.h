@@ -35,6 +35,9 @@
 #include <stdexcept>
 #include <cstdint>
 #include <string.h> //memcpy
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 #ifdef _MSC_VER
 #  include <pmmintrin.h>
@@ -89,6 +92,27 @@ public:
         //stub
     }
 
+    template<typename T>
+    struct is_transparent {
+        template<typename U> static std::true_type test(typename U::is_transparent*);
+        template<typename U> static std::false_type test(...);
+        static const bool value = decltype(test<T>(nullptr))::value;
+    };
+
+    struct lookup_any_ {
+        template<class K, class Key>
+        using type = K;
+    };
+
+    struct lookup_exact_ {
+        template<class K, class Key>
+        using type = Key;
+    };
+
+    //type<K, Key> is K if both Hasher and KeyEql declare is_transparent (lookup without temporary key), Key otherwise
+    template<class Hasher, class KeyEql>
+    using lookup_key = typename std::conditional<is_transparent<Hasher>::value && is_transparent<KeyEql>::value, lookup_any_, lookup_exact_>::type;
+
     template <class Key, class Hasher, class KeyEql>
     class
 #if defined(_MSC_VER) && _MSC_VER >= 1915
@@ -113,8 +137,10 @@ public:
             return *this;
         }
 
-        HRD_ALWAYS_INLINE size_t operator()(const Key& k) const { return static_cast<size_t>(hasher()(k)); }
-        HRD_ALWAYS_INLINE bool operator()(const Key& k1, const Key& k2) const { return keyeql()(k1, k2); }
+        template<typename K>
+        HRD_ALWAYS_INLINE size_t operator()(const K& k) const { return static_cast<size_t>(hasher()(k)); }
+        template<typename K1, typename K2>
+        HRD_ALWAYS_INLINE bool operator()(const K1& k1, const K2& k2) const { return keyeql()(k1, k2); }
 
         void swap(hash_eql& r) noexcept {
             std::swap(const_cast<Hasher&>(hasher()), const_cast<Hasher&>(r.hasher()));
@@ -650,7 +676,13 @@ protected:
 
     //all needed space should be allocated before
     template<typename V, class this_type>
-    HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, this_type& ref, std::true_type)
+    HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, this_type& ref, std::true_type) {
+        return insert_(std::forward<V>(val), ref(this_type::key_getter::get_key(val)), ref, std::true_type());
+    }
+
+    //all needed space should be allocated before, h - hash of val key
+    template<typename V, class this_type>
+    HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, size_t h, this_type& ref, std::true_type)
     {
         size_t empty_spot = SIZE_MAX;
         uint32_t deleted_mark = DELETED_MARK;
@@ -658,7 +690,7 @@ protected:
         typedef typename this_type::iterator iter;
         typename this_type::storage_type* ee = reinterpret_cast<typename this_type::storage_type*>(_elements + align_ppow2(_capacity));
 
-        for (size_t i = ref(this_type::key_getter::get_key(val));; ++i)
+        for (size_t i = h;; ++i)
         {
             i &= _capacity;
 
@@ -704,12 +736,29 @@ protected:
         return insert_(std::forward<V>(val), ref, std::true_type());
     }
 
+    //probe available size each time, h - hash of val key
+    template<typename V, class this_type>
+    HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, size_t h, this_type& ref, std::false_type)
+    {
+        size_t used = _erased + _size;
+        if (HRD_UNLIKELY(_capacity - used <= used))
+            resize_pow2(2 * (_capacity + 1), ref);
+
+        return insert_(std::forward<V>(val), h, ref, std::true_type());
+    }
+
+    template<typename key_type, class this_type>
+    HRD_ALWAYS_INLINE typename this_type::storage_type* find_(const key_type& k, const this_type& ref) const noexcept {
+        return find_(k, ref(k), ref);
+    }
+
+    //h - hash of k
     template<typename key_type, class this_type>
-    HRD_ALWAYS_INLINE typename this_type::storage_type* find_(const key_type& k, const this_type& ref) const noexcept
+    HRD_ALWAYS_INLINE typename this_type::storage_type* find_(const key_type& k, size_t h, const this_type& ref) const noexcept
     {
         auto ee = (typename this_type::storage_type*)(_elements + align_ppow2(_capacity));
 
-        for (size_t i = ref(k);;++i)
+        for (size_t i = h;;++i)
         {
             i &= _capacity;
 
@@ -725,12 +774,17 @@ protected:
     }
 
     template<typename key_type, class this_type>
-    HRD_ALWAYS_INLINE typename this_type::iterator find_iter_(const key_type& k, const this_type& ref) const noexcept
+    HRD_ALWAYS_INLINE typename this_type::iterator find_iter_(const key_type& k, const this_type& ref) const noexcept {
+        return find_iter_(k, ref(k), ref);
+    }
+
+    template<typename key_type, class this_type>
+    HRD_ALWAYS_INLINE typename this_type::iterator find_iter_(const key_type& k, size_t h, const this_type& ref) const noexcept
     {
         typedef typename this_type::iterator iter;
         typename this_type::storage_type* ee = (typename this_type::storage_type*)(_elements + align_ppow2(_capacity));
 
-        for (size_t i = ref(k);; ++i)
+        for (size_t i = h;; ++i)
         {
             i &= _capacity;
 
@@ -784,12 +838,17 @@ protected:
         return ret;
     }
 
-    template <class this_type>
-    HRD_ALWAYS_INLINE size_type erase_(const typename this_type::key_type& k, this_type& ref) noexcept
+    template <typename key_type, class this_type>
+    HRD_ALWAYS_INLINE size_type erase_(const key_type& k, this_type& ref) noexcept {
+        return erase_(k, ref(k), ref);
+    }
+
+    template <typename key_type, class this_type>
+    HRD_ALWAYS_INLINE size_type erase_(const key_type& k, size_t h, this_type& ref) noexcept
     {
         typename this_type::storage_type* ee = (typename this_type::storage_type*)(_elements + align_ppow2(_capacity));
 
-        for (size_t i = ref(k);; ++i)
+        for (size_t i = h;; ++i)
         {
             i &= _capacity;
 
@@ -952,12 +1011,27 @@ HRD_ALWAYS_INLINE size_t hash_base::hash_1<16>(const void* ptr) noexcept
     return hash32 ^ (hash32 >> 16);
 }
 
+#if __cplusplus >= 201703L
+template<>
+struct hash_base::hash_<std::string_view> {
+    typedef void is_transparent;
+
+    HRD_ALWAYS_INLINE size_t operator()(std::string_view val) const noexcept {
+        return hash_base::fnv_1a(val.data(), val.size());
+    }
+};
+
+//std::string, std::string_view and const char* of the same text hash equally: with std::equal_to<> std::string table is searched by any of them
+template<>
+struct hash_base::hash_<std::string> : public hash_base::hash_<std::string_view> {};
+#else
 template<>
 struct hash_base::hash_<std::string> {
     HRD_ALWAYS_INLINE size_t operator()(const std::string& val) const noexcept {
         return hash_base::fnv_1a(val.c_str(), val.size());
     }
 };
+#endif
 
 //----------------------------------------- hash_set -----------------------------------------
 
@@ -1002,6 +1076,10 @@ public:
     typedef typename iterator_base<this_type>::iterator iterator;
     typedef typename iterator_base<this_type>::const_iterator const_iterator;
 
+    //key type of lookups, see hash_base::lookup_key
+    template<class K>
+    using key_arg = typename lookup_key<Hash, Pred>::template type<K, key_type>;
+
     hash_set() {
         ctor_empty();
     }
@@ -1117,18 +1195,48 @@ public:
         return insert_(std::forward<K>(val), const_cast<this_type&>(*this), std::false_type());
     }
 
-    HRD_ALWAYS_INLINE iterator find(const key_type& k) noexcept {
+    /*! Can invalidate iterators.
+    * \params hash - hash of val computed before by hasher, the same key looked up in several tables is hashed once
+    */
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(const key_type& val, size_t hash) {
+        return insert_(val, hash, *this, std::false_type());
+    }
+
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(key_type&& val, size_t hash) {
+        return insert_(std::move(val), hash, *this, std::false_type());
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE iterator find(const key_arg<K>& k) noexcept {
         return find_iter_(k, *this);
     }
 
-    HRD_ALWAYS_INLINE const_iterator find(const key_type& k) const noexcept {
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE const_iterator find(const key_arg<K>& k) const noexcept {
         return find_iter_(k, *this);
     }
 
-    HRD_ALWAYS_INLINE size_type count(const key_type& k) const noexcept {
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type count(const key_arg<K>& k) const noexcept {
         return find_(k, *this) != nullptr;
     }
 
+    //lookups by hash of k computed before, see insert(val, hash)
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE iterator find(const key_arg<K>& k, size_t hash) noexcept {
+        return find_iter_(k, hash, *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE const_iterator find(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_iter_(k, hash, *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type count(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash, *this) != nullptr;
+    }
+
     /*! Can invalidate iterators.
     * \params it - Iterator pointing to a single element to be removed
     * \return an iterator pointing to the position immediately following of the element erased
@@ -1137,14 +1245,25 @@ public:
         return erase_<this_type>(it);
     }
 
+    //exact match for iterator argument, erase(key_arg<K>) of transparent table takes it otherwise
+    HRD_ALWAYS_INLINE iterator erase(iterator it) noexcept {
+        return erase(const_iterator(it));
+    }
+
     /*! Can invalidate iterators.
     * \params k - Key of the element to be erased
     * \return 1 - if element erased and zero otherwise
     */
-    inline size_type erase(const key_type& k) noexcept {
+    template<class K = key_type>
+    inline size_type erase(const key_arg<K>& k) noexcept {
         return erase_(k, *this);
     }
 
+    template<class K = key_type>
+    inline size_type erase(const key_arg<K>& k, size_t hash) noexcept {
+        return erase_(k, hash, *this);
+    }
+
     void shrink_to_fit() {
         hash_base::shrink_to_fit<this_type>(*this);
     }
@@ -1209,6 +1328,10 @@ public:
     typedef typename iterator_base<this_type>::iterator iterator;
     typedef typename iterator_base<this_type>::const_iterator const_iterator;
 
+    //key type of lookups, see hash_base::lookup_key
+    template<class K>
+    using key_arg = typename lookup_key<Hash, Pred>::template type<K, key_type>;
+
     hash_map() {
         ctor_empty();
     }
@@ -1323,6 +1446,19 @@ public:
     HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
         return emplace_(std::forward<K>(key), std::forward<Args>(args)...);
     }
+
+    /*! Can invalidate iterators. Probes first: mapped value constructed from args only if k is absent, args untouched otherwise.
+    * \return iterator to the element with key k and true if inserted
+    */
+    template<class... Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+        return emplace_(k, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+        return emplace_(std::move(k), std::forward<Args>(args)...);
+    }
 #else
     template<class Args>
     HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace(const Key& key, Args&& args) {
@@ -1335,18 +1471,67 @@ public:
     }
 #endif //C++-11 support
 
-    HRD_ALWAYS_INLINE iterator find(const key_type& k) noexcept {
+    /*! Can invalidate iterators. obj assigned to mapped value of present k, inserted with k (constructed from obj) otherwise.
+    * \return iterator to the element with key k and true if inserted
+    */
+    template<class M>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+        std::pair<iterator, bool> ret = emplace_(k, std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+
+    template<class M>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+        std::pair<iterator, bool> ret = emplace_(std::move(k), std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+
+    /*! Can invalidate iterators.
+    * \params hash - hash of val.first computed before by hasher, the same key looked up in several tables is hashed once
+    */
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(const value_type& val, size_t hash) {
+        return insert_(val, hash, *this, std::false_type());
+    }
+
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(value_type&& val, size_t hash) {
+        return insert_(std::move(val), hash, *this, std::false_type());
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE iterator find(const key_arg<K>& k) noexcept {
         return find_iter_(k, *this);
     }
 
-    HRD_ALWAYS_INLINE const_iterator find(const key_type& k) const noexcept {
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE const_iterator find(const key_arg<K>& k) const noexcept {
         return find_iter_(k, *this);
     }
 
-    HRD_ALWAYS_INLINE size_type count(const key_type& k) const noexcept {
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type count(const key_arg<K>& k) const noexcept {
         return find_(k, *this) != nullptr;
     }
 
+    //lookups by hash of k computed before, see insert(val, hash)
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE iterator find(const key_arg<K>& k, size_t hash) noexcept {
+        return find_iter_(k, hash, *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE const_iterator find(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_iter_(k, hash, *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type count(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash, *this) != nullptr;
+    }
+
     /*! Doesn't invalidate iterators.
     * \params it - Iterator pointing to a single element to be removed
     * \return return an iterator pointing to the position immediately following of the element erased
@@ -1355,14 +1540,25 @@ public:
         return erase_<this_type>(it);
     }
 
+    //exact match for iterator argument, erase(key_arg<K>) of transparent table takes it otherwise
+    HRD_ALWAYS_INLINE iterator erase(iterator it) noexcept {
+        return erase(const_iterator(it));
+    }
+
     /*! Doesn't invalidate iterators.
     * \params k - Key of the element to be erased
     * \return 1 - if element erased and zero otherwise
     */
-    HRD_ALWAYS_INLINE size_type erase(const key_type& k) noexcept {
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type erase(const key_arg<K>& k) noexcept {
         return erase_(k, *this);
     }
 
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type erase(const key_arg<K>& k, size_t hash) noexcept {
+        return erase_(k, hash, *this);
+    }
+
     HRD_ALWAYS_INLINE void shrink_to_fit() {
         hash_base::shrink_to_fit<this_type>(*this);
     }
@@ -1378,11 +1574,20 @@ public:
     }
 
     HRD_ALWAYS_INLINE mapped_type& operator[](const key_type& k) {
-        return find_insert(k);
+        return find_insert_(k, hash_pred::operator()(k));
     }
 
     HRD_ALWAYS_INLINE mapped_type& operator[](key_type&& k) {
-        return find_insert(std::move(k));
+        return find_insert_(std::move(k), hash_pred::operator()(k));
+    }
+
+    //operator[] by hash of k computed before, see insert(val, hash)
+    HRD_ALWAYS_INLINE mapped_type& find_insert(const key_type& k, size_t hash) {
+        return find_insert_(k, hash);
+    }
+
+    HRD_ALWAYS_INLINE mapped_type& find_insert(key_type&& k, size_t hash) {
+        return find_insert_(std::move(k), hash);
     }
 
 private:
@@ -1443,7 +1648,7 @@ private:
     }
 
     template<typename V>
-    HRD_ALWAYS_INLINE mapped_type& find_insert(V&& k)
+    HRD_ALWAYS_INLINE mapped_type& find_insert_(V&& k, size_t h)
     {
         size_type used = _erased + _size;
         if (HRD_UNLIKELY(_capacity - used <= used))
@@ -1453,7 +1658,7 @@ private:
         uint32_t deleted_mark = DELETED_MARK;
         auto ee = reinterpret_cast<storage_type*>(_elements + align_ppow2(_capacity));
 
-        for (size_t i = hash_pred::operator()(k);; ++i)
+        for (size_t i = h;; ++i)
         {
             i &= _capacity;
             storage_type* r = ee + i;
@@ -0,0 +1,287 @@
+#pragma once
+
+// Memory-mapped read-only snapshots of trivially copyable hrd tables (hash_set.h), C++17 and up
+// version 1.0.0
+//
+// https://github.com/hordi/hash
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018-2026 Yurii Hordiienko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "hash_set.h"
+#include <string>
+#include <system_error>
+#include <typeinfo>
+#include <cerrno>
+#include <cstdio>
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace hrd {
+
+#pragma region hash_mapped
+
+/**
+ * Snapshot file: header then storage block as is (marks followed by slots), so it can be served from mmap without copy.
+ * Table identity checked on open: layout version, build options affecting hashes/marks, hash of typeid(Table).name()
+ * (key, value, hasher and key-equal types) and sizes.
+ */
+struct hash_snapshot_header
+{
+    constexpr static const char MAGIC[8] = { 'H', 'R', 'D', 'S', 'N', 'A', 'P', '\0' };
+    constexpr static uint32_t VERSION = 1;
+
+    char     magic[8];
+    uint32_t version;
+    uint32_t config;      //HRD_FNV_HASH, HRD_MARK_FINGERPRINT, mark_group::WIDTH
+    uint64_t type_id;
+    uint64_t value_size;
+    uint64_t size;
+    uint64_t capacity;
+    uint64_t erased;
+    uint64_t gap;
+    uint64_t marks_size;  //slots offset inside block
+    uint64_t block_size;
+    uint8_t  reserved[48];
+};
+static_assert(sizeof(hash_snapshot_header) == 128, "keep block 64-bytes aligned in file");
+
+/**
+ * Read-only hash_set/hash_grow_set/hash_map/hash_grow_map of trivially copyable data served from memory-mapped snapshot
+ * written by hash_mapped<Table>::save(): table() is an ordinary const Table whose storage is the mapped file,
+ * so find/count/contains/find_many/iteration work without loading. Pages are read by OS on first access.
+ * Header and marks of the file are validated on open (marks are read once), damaged snapshot is rejected instead of crashing lookup.
+ */
+template<class table_type>
+class hash_mapped
+{
+public:
+    using value_type = typename table_type::value_type;
+
+    static_assert(std::is_trivially_copy_constructible<value_type>::value && std::is_trivially_destructible<value_type>::value,
+        "only tables of trivially copyable data can be mapped");
+
+    explicit hash_mapped(const char* path) : _map(nullptr), _map_size(0)
+    {
+        map_(path);
+        const auto* hdr = static_cast<const hash_snapshot_header*>(_map);
+        if (_map_size < sizeof(hash_snapshot_header) || !check_(*hdr, _map_size) ||
+            !check_marks_((const std::byte*)_map + sizeof(hash_snapshot_header), *hdr)) {
+            unmap_();
+            throw std::runtime_error(std::string("hrd::hash_mapped: incompatible snapshot ") + path);
+        }
+
+        if (hdr->capacity) {
+            _table._size     = (hash_base::size_type)hdr->size;
+            _table._capacity = (hash_base::size_type)hdr->capacity;
+            _table._erased   = (hash_base::size_type)hdr->erased;
+            _table._gap      = (hash_base::size_type)hdr->gap;
+            _table._elements = (std::byte*)_map + sizeof(hash_snapshot_header);
+        }
+    }
+
+    hash_mapped(hash_mapped&& r) noexcept : _table(std::move(r._table)), _map(r._map), _map_size(r._map_size) {
+        r._map = nullptr;
+        r._map_size = 0;
+    }
+
+    hash_mapped(const hash_mapped&) = delete;
+    hash_mapped& operator=(const hash_mapped&) = delete;
+
+    ~hash_mapped() {
+        _table.ctor_empty(); //storage is not owned by table
+        unmap_();
+    }
+
+    const table_type& table() const noexcept { return _table; }
+    const table_type& operator*() const noexcept { return _table; }
+    const table_type* operator->() const noexcept { return &_table; }
+
+    //write snapshot of "table" to "path" (truncated), throws std::system_error
+    static void save(const table_type& table, const char* path)
+    {
+        hash_snapshot_header hdr = make_header_(table);
+
+        FILE* f = fopen(path, "wb");
+        if (!f)
+            throw std::system_error(errno, std::generic_category(), std::string("hrd::hash_mapped::save: ") + path);
+
+        bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+            (!hdr.block_size || fwrite(table._elements, (size_t)hdr.block_size, 1, f) == 1);
+        int err = errno;
+        ok = (fclose(f) == 0) && ok;
+        if (!ok) {
+            remove(path);
+            throw std::system_error(err ? err : EIO, std::generic_category(), std::string("hrd::hash_mapped::save: ") + path);
+        }
+    }
+
+private:
+    constexpr static uint32_t config_() noexcept {
+        return (uint32_t)HRD_FNV_HASH | ((uint32_t)HRD_MARK_FINGERPRINT << 1) | ((uint32_t)hash_base::mark_group::WIDTH << 8);
+    }
+
+    static uint64_t type_id_() noexcept {
+        const char* name = typeid(table_type).name();
+        return hash_base::hash_bytes(name, strlen(name));
+    }
+
+    static hash_snapshot_header make_header_(const table_type& table) noexcept
+    {
+        hash_snapshot_header hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, hash_snapshot_header::MAGIC, sizeof(hdr.magic));
+        hdr.version    = hash_snapshot_header::VERSION;
+        hdr.config     = config_();
+        hdr.type_id    = type_id_();
+        hdr.value_size = sizeof(value_type);
+        if (table._capacity) {
+            hdr.size       = table._size;
+            hdr.capacity   = table._capacity;
+            hdr.erased     = table._erased;
+            hdr.gap        = table._gap;
+            hdr.marks_size = hash_base::align_ppow2<table_type>(table._capacity);
+            hdr.block_size = hdr.marks_size + (table._capacity + 1) * sizeof(*table.template data_<table_type>());
+        }
+        return hdr;
+    }
+
+    static bool check_(const hash_snapshot_header& hdr, size_t file_size) noexcept
+    {
+        if (memcmp(hdr.magic, hash_snapshot_header::MAGIC, sizeof(hdr.magic)) || hdr.version != hash_snapshot_header::VERSION ||
+            hdr.config != config_() || hdr.type_id != type_id_() || hdr.value_size != sizeof(value_type))
+            return false;
+        if (!hdr.capacity)
+            return !hdr.size && file_size == sizeof(hdr);
+
+        size_t slot_size = sizeof(*std::declval<const table_type&>().template data_<table_type>());
+        return ((hdr.capacity + 1) & hdr.capacity) == 0 && hdr.size <= hdr.capacity && //capacity is (pow2 - 1)
+            hdr.marks_size == hash_base::align_ppow2<table_type>((size_t)hdr.capacity) &&
+            hdr.block_size == hdr.marks_size + (hdr.capacity + 1) * slot_size &&
+            file_size == sizeof(hdr) + hdr.block_size;
+    }
+
+    //marks are used as-is by lookup and iteration: "size" used ones (iterator stops after them), empty one (probe sequence ends at it).
+    //One pass over marks only, slots are not touched
+    static bool check_marks_(const std::byte* marks, const hash_snapshot_header& hdr) noexcept
+    {
+        if (!hdr.capacity)
+            return true;
+
+        uint64_t used = 0, empty = 0;
+        for (uint64_t i = 0; i <= hdr.capacity; ++i) {
+            used  += hash_base::is_used(marks[i]);
+            empty += (marks[i] == hash_base::EMPTY_MARK);
+        }
+        return used == hdr.size && empty;
+    }
+
+#ifdef _WIN32
+    void map_(const char* path)
+    {
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw std::system_error((int)GetLastError(), std::system_category(), std::string("hrd::hash_mapped: ") + path);
+
+        LARGE_INTEGER len;
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &len) && len.QuadPart)
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        DWORD err = GetLastError();
+        CloseHandle(file);
+        if (!mapping)
+            throw std::system_error((int)err, std::system_category(), std::string("hrd::hash_mapped: ") + path);
+
+        _map = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        err = GetLastError();
+        CloseHandle(mapping);
+        if (!_map)
+            throw std::system_error((int)err, std::system_category(), std::string("hrd::hash_mapped: ") + path);
+        _map_size = (size_t)len.QuadPart;
+    }
+
+    void unmap_() noexcept {
+        if (_map)
+            UnmapViewOfFile(_map);
+        _map = nullptr;
+    }
+#else
+    void map_(const char* path)
+    {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), std::string("hrd::hash_mapped: ") + path);
+
+        struct stat st;
+        void* p = MAP_FAILED;
+        if (fstat(fd, &st) == 0) {
+            if (st.st_size)
+                p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            else
+                errno = EINVAL;
+        }
+        int err = errno;
+        ::close(fd);
+        if (p == MAP_FAILED)
+            throw std::system_error(err, std::generic_category(), std::string("hrd::hash_mapped: ") + path);
+
+        _map = p;
+        _map_size = (size_t)st.st_size;
+    }
+
+    void unmap_() noexcept {
+        if (_map)
+            munmap(_map, _map_size);
+        _map = nullptr;
+    }
+#endif
+
+    table_type _table;
+    void* _map;
+    size_t _map_size;
+};
+
+#pragma endregion hash_mapped
+
+//write snapshot of trivially copyable hash_set/hash_grow_set/hash_map/hash_grow_map, see hash_mapped
+template<class table_type>
+void save(const table_type& table, const char* path) {
+    hash_mapped<table_type>::save(table, path);
+}
+
+//zero-copy read-only table of snapshot written by save()
+template<class table_type>
+hash_mapped<table_type> open_mapped(const char* path) {
+    return hash_mapped<table_type>(path);
+}
+
+} //namespace hrd
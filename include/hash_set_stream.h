@@ -0,0 +1,369 @@
+#pragma once
+
+// Streaming serialization of hrd tables (hash_set.h), C++17 and up
+// version 1.0.0
+//
+// https://github.com/hordi/hash
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018-2026 Yurii Hordiienko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "hash_set.h"
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace hrd {
+
+#pragma region serializer
+
+///Element codec used by serialize()/deserialize(): write(out, value) calls out.put(ptr, len), read(in) calls in.get(ptr, len).
+///Trivially copyable types are written as is, std::basic_string, std::vector and std::pair supported, specialize for others.
+template<class T, class Enable = void>
+struct serializer
+{
+    static_assert(std::is_trivially_copyable<T>::value, "specialize hrd::serializer<T> for not trivially copyable type");
+
+    template<class Out>
+    static void write(Out& out, const T& v) {
+        out.put(&v, sizeof(T));
+    }
+
+    template<class In>
+    static T read(In& in) {
+        alignas(T) unsigned char buf[sizeof(T)];
+        in.get(buf, sizeof(T));
+        T v;
+        memcpy((void*)&v, buf, sizeof(T));
+        return v;
+    }
+};
+
+template<class C, class Tr, class A>
+struct serializer<std::basic_string<C, Tr, A>>
+{
+    using value_type = std::basic_string<C, Tr, A>;
+
+    template<class Out>
+    static void write(Out& out, const value_type& v) {
+        uint64_t len = v.size();
+        out.put(&len, sizeof(len));
+        out.put(v.data(), len * sizeof(C));
+    }
+
+    template<class In>
+    static value_type read(In& in) {
+        uint64_t len;
+        in.get(&len, sizeof(len));
+        in.check(len * sizeof(C));
+        value_type v((size_t)len, C());
+        in.get(&v[0], (size_t)len * sizeof(C));
+        return v;
+    }
+};
+
+template<class T, class A>
+struct serializer<std::vector<T, A>>
+{
+    using value_type = std::vector<T, A>;
+
+    template<class Out>
+    static void write(Out& out, const value_type& v) {
+        uint64_t len = v.size();
+        out.put(&len, sizeof(len));
+        if constexpr (std::is_trivially_copyable<T>::value && !std::is_same<T, bool>::value) {
+            out.put(v.data(), len * sizeof(T));
+        }
+        else {
+            for (const auto& e : v)
+                serializer<T>::write(out, e);
+        }
+    }
+
+    template<class In>
+    static value_type read(In& in) {
+        uint64_t len;
+        in.get(&len, sizeof(len));
+        value_type v;
+        if constexpr (std::is_trivially_copyable<T>::value && !std::is_same<T, bool>::value) {
+            in.check(len * sizeof(T));
+            v.resize((size_t)len);
+            in.get(v.data(), (size_t)len * sizeof(T));
+        }
+        else {
+            in.check(len); //at least one byte per element, bounds reserve() by remaining data
+            v.reserve((size_t)len);
+            for (uint64_t i = 0; i < len; ++i)
+                v.push_back(serializer<T>::read(in));
+        }
+        return v;
+    }
+};
+
+template<class T1, class T2>
+struct serializer<std::pair<T1, T2>>
+{
+    using first_type  = typename std::remove_const<T1>::type;
+    using second_type = typename std::remove_const<T2>::type;
+
+    template<class Out>
+    static void write(Out& out, const std::pair<T1, T2>& v) {
+        serializer<first_type>::write(out, v.first);
+        serializer<second_type>::write(out, v.second);
+    }
+
+    template<class In>
+    static std::pair<first_type, second_type> read(In& in) {
+        first_type first = serializer<first_type>::read(in);
+        return std::pair<first_type, second_type>(std::move(first), serializer<second_type>::read(in));
+    }
+};
+
+#pragma endregion serializer
+
+#pragma region hash_stream
+
+/**
+ * Stream: header (magic, version, elements count) then chunks {uint64 elements, uint64 bytes, encoded elements},
+ * zero elements chunk ends the stream. Sink/source see chunk-sized calls only, whole table is never buffered.
+ * Reader never asks more than the stream contains, so data can follow the table in the same stream.
+ */
+template<class table_type>
+struct hash_stream
+{
+    using value_type = typename table_type::value_type;
+    using codec      = serializer<typename std::remove_const<value_type>::type>;
+
+    constexpr static char MAGIC[8] = { 'H', 'R', 'D', 'S', 'T', 'R', 'M', '\0' };
+    constexpr static uint32_t VERSION = 1;
+    constexpr static size_t CHUNK_SIZE = 64 * 1024;
+
+    struct header {
+        char     magic[8];
+        uint32_t version;
+        uint32_t value_size; //sizeof(value_type), rejects type mismatch for trivial data
+        uint64_t size;
+    };
+
+    //writer(const void* data, size_t len) -> bool
+    template<class Writer>
+    static void serialize(const table_type& table, Writer& writer)
+    {
+        header hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, MAGIC, sizeof(MAGIC));
+        hdr.version = VERSION;
+        hdr.value_size = sizeof(value_type);
+        hdr.size = table.size();
+        write_(writer, &hdr, sizeof(hdr));
+
+        chunk_writer<Writer> out(writer);
+        for (const auto& v : table) {
+            codec::write(out, v);
+            out.next();
+        }
+        out.flush();
+        uint64_t end[2] = { 0, 0 };
+        write_(writer, end, sizeof(end));
+    }
+
+    //reader(void* data, size_t len) -> bool, true if exactly len bytes read. Strong exception guarantee
+    template<class Reader>
+    static void deserialize(table_type& table, Reader& reader)
+    {
+        header hdr;
+        read_(reader, &hdr, sizeof(hdr));
+        if (memcmp(hdr.magic, MAGIC, sizeof(MAGIC)) || hdr.version != VERSION || hdr.value_size != sizeof(value_type))
+            throw std::runtime_error("hrd::deserialize: incompatible stream");
+
+        //stored elements count is not trusted for allocation: storage grows by elements of chunks already read
+        //same hasher, key_equal and allocator as "table": swap() below propagates them
+        table_type tmp(0,
+            static_cast<const typename table_type::hasher_type&>(table), static_cast<const typename table_type::keyeql_type&>(table),
+            table.get_allocator());
+        if (hdr.size) {
+            chunk_reader<Reader> in(reader);
+            uint64_t total = 0;
+            while (uint64_t cnt = in.next()) {
+                if (HRD_UNLIKELY(cnt > hdr.size - total))
+                    throw std::runtime_error("hrd::deserialize: corrupted stream");
+                total += cnt;
+                tmp.reserve((typename table_type::size_type)total);
+                if constexpr (is_rh_<table_type>::value) {
+                    //Robin Hood clusters are sorted by home slot with distance in the mark: placed by the table itself
+                    for (; cnt; --cnt) {
+                        auto v = codec::read(in);
+                        size_t h = tmp(v.first);
+                        if (HRD_UNLIKELY(!tmp.emplace_hashed_(h, std::move(v.first), std::move(v.second)).second))
+                            throw std::runtime_error("hrd::deserialize: corrupted stream");
+                    }
+                }
+                else {
+                    //keys are unique by construction: placed to the first empty slot, no lookup
+                    auto* ee = tmp.template data_<table_type>();
+                    for (; cnt; --cnt) {
+                        auto v = codec::read(in);
+                        size_t h = tmp(key_(v));
+                        size_t i = hash_base::empty_pos_(tmp._elements, tmp._capacity, h);
+                        new ((void*)&ee[i].data) typename std::remove_const<value_type>::type(std::move(v));
+                        tmp._elements[i] = hash_base::make_mark(h);
+                        tmp._size++;
+                    }
+                }
+                in.done();
+            }
+            if (HRD_UNLIKELY(total != hdr.size))
+                throw std::runtime_error("hrd::deserialize: corrupted stream");
+        }
+        else {
+            uint64_t end[2];
+            read_(reader, end, sizeof(end));
+            if (end[0] || end[1])
+                throw std::runtime_error("hrd::deserialize: corrupted stream");
+        }
+        table.swap(tmp);
+    }
+
+private:
+    template<class T>
+    struct is_rh_ : std::false_type {};
+
+    template<class Key, class T, class Hash, class Pred, class Alloc>
+    struct is_rh_<hash_map_rh<Key, T, Hash, Pred, Alloc>> : std::true_type {};
+
+    //key of decoded element: sets keep key itself, maps - pair<key, mapped>
+    template<class V>
+    static const typename table_type::key_type& key_(const V& v) noexcept {
+        if constexpr (std::is_same<V, typename table_type::key_type>::value)
+            return v;
+        else
+            return v.first;
+    }
+
+    template<class Writer>
+    static void write_(Writer& writer, const void* data, size_t len) {
+        if (HRD_UNLIKELY(!writer(data, len)))
+            throw std::runtime_error("hrd::serialize: write failed");
+    }
+
+    template<class Reader>
+    static void read_(Reader& reader, void* data, size_t len) {
+        if (HRD_UNLIKELY(!reader(data, len)))
+            throw std::runtime_error("hrd::deserialize: unexpected end of stream");
+    }
+
+    template<class Writer>
+    class chunk_writer
+    {
+    public:
+        explicit chunk_writer(Writer& w) : _writer(w), _cnt(0) { _buf.reserve(CHUNK_SIZE); }
+
+        void put(const void* data, size_t len) {
+            _buf.insert(_buf.end(), (const char*)data, (const char*)data + len);
+        }
+        //element encoded
+        void next() {
+            ++_cnt;
+            if (_buf.size() >= CHUNK_SIZE)
+                flush();
+        }
+        void flush() {
+            if (!_cnt)
+                return;
+            uint64_t hdr[2] = { _cnt, _buf.size() };
+            write_(_writer, hdr, sizeof(hdr));
+            write_(_writer, _buf.data(), _buf.size());
+            _buf.clear();
+            _cnt = 0;
+        }
+
+    private:
+        Writer& _writer;
+        std::vector<char> _buf;
+        uint64_t _cnt;
+    };
+
+    template<class Reader>
+    class chunk_reader
+    {
+    public:
+        explicit chunk_reader(Reader& r) : _reader(r), _pos(0) {}
+
+        //load next chunk, return its elements count (0 - end of stream)
+        uint64_t next() {
+            uint64_t hdr[2];
+            read_(_reader, hdr, sizeof(hdr));
+            //at least one byte per element: count is bounded by chunk bytes actually read
+            if (HRD_UNLIKELY(!hdr[0] != !hdr[1] || hdr[0] > hdr[1] || hdr[1] > SIZE_MAX / 2))
+                throw std::runtime_error("hrd::deserialize: corrupted stream");
+            _buf.resize((size_t)hdr[1]);
+            if (hdr[1])
+                read_(_reader, _buf.data(), _buf.size());
+            _pos = 0;
+            return hdr[0];
+        }
+        //all chunk bytes must be consumed by its elements
+        void done() const {
+            if (HRD_UNLIKELY(_pos != _buf.size()))
+                throw std::runtime_error("hrd::deserialize: corrupted stream");
+        }
+        //"len" bytes available in the chunk
+        void check(uint64_t len) const {
+            if (HRD_UNLIKELY(len > _buf.size() - _pos))
+                throw std::runtime_error("hrd::deserialize: corrupted stream");
+        }
+        void get(void* data, size_t len) {
+            check(len);
+            if (len)
+                memcpy(data, _buf.data() + _pos, len);
+            _pos += len;
+        }
+
+    private:
+        Reader& _reader;
+        std::vector<char> _buf;
+        size_t _pos;
+    };
+};
+
+#pragma endregion hash_stream
+
+/**
+ * Write all elements of hash_set/hash_grow_set/hash_map/hash_grow_map/hash_map_rh by writer(const void* data, size_t len) -> bool
+ * (false means failure, std::runtime_error thrown). Elements encoded by hrd::serializer<value_type>.
+ */
+template<class table_type, class Writer>
+void serialize(const table_type& table, Writer&& writer) {
+    hash_stream<table_type>::serialize(table, writer);
+}
+
+/**
+ * Replace content of "table" by stream written by serialize(), reader(void* data, size_t len) -> bool must read exactly len bytes.
+ * Storage grows by decoded chunks, not by the stored elements count; elements placed without duplicate checks
+ * (hash_map_rh inserts them by Robin Hood order, duplicate key is a corrupted stream). Table unchanged on exception.
+ */
+template<class table_type, class Reader>
+void deserialize(table_type& table, Reader&& reader) {
+    hash_stream<table_type>::deserialize(table, reader);
+}
+
+} //namespace hrd
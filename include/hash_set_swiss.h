@@ -0,0 +1,1449 @@
+#pragma once
+
+//Control bytes grouped by 16 (SSE2), H1/H2 hash split, quadratic probing over groups
+
+// Fast hashtable (hash_set, hash_map) based on open addressing hashing for C++11 and up
+//
+// Swiss-table layout: one control byte per slot (7 bits of hash if used), 16 control bytes compared by one SSE2 instruction
+// version 1.0.0
+//
+// https://github.com/hordi/hash
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018-2026 Yurii Hordiienko
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <cstdint>
+#include <string.h> //memcpy
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+#ifdef _MSC_VER
+#  include <intrin.h>
+#  include <emmintrin.h>
+#  define HRD_ALWAYS_INLINE __forceinline
+#  define HRD_LIKELY(condition) condition
+#  define HRD_UNLIKELY(condition) condition
+#  define HRD_ATTR_NOINLINE __declspec(noinline)
+#  define HRD_ATTR_NORETURN __declspec(noreturn)
+#else
+#  include <x86intrin.h>
+#  define HRD_ALWAYS_INLINE __attribute__((always_inline)) inline
+#  define HRD_LIKELY(condition) __builtin_expect(condition, 1)
+#  define HRD_UNLIKELY(condition) __builtin_expect(condition, 0)
+#  define HRD_ATTR_NOINLINE __attribute__((noinline))
+#  define HRD_ATTR_NORETURN __attribute__((noreturn))
+#endif
+
+namespace hrd_swiss {
+
+class hash_base
+{
+public:
+    typedef size_t size_type;
+
+    template<typename T>
+    struct hash_ : public std::hash<T> {
+        HRD_ALWAYS_INLINE size_t operator()(const T& val) const noexcept {
+            return hash_base::hash_1<sizeof(T)>(&val);
+        }
+    };
+
+    template<size_t SIZE>
+    static size_t hash(const void* ptr) noexcept {
+        return hash_1<SIZE>(ptr);
+    }
+
+    size_type size() const noexcept { return _size; }
+    size_type capacity() const noexcept { return _capacity; }
+
+    bool empty() const noexcept { return !_size; }
+
+    float load_factor() const noexcept {
+        return (float)_size / (float)(_capacity + 1);
+    }
+
+    float max_load_factor() const noexcept {
+        //stub
+        return 0.875f;
+    }
+
+    void max_load_factor(float) noexcept {
+        //stub
+    }
+
+    template<typename T>
+    struct is_transparent {
+        template<typename U> static std::true_type test(typename U::is_transparent*);
+        template<typename U> static std::false_type test(...);
+        static const bool value = decltype(test<T>(nullptr))::value;
+    };
+
+    struct lookup_any_ {
+        template<class K, class Key>
+        using type = K;
+    };
+
+    struct lookup_exact_ {
+        template<class K, class Key>
+        using type = Key;
+    };
+
+    //type<K, Key> is K if both Hasher and KeyEql declare is_transparent (lookup without temporary key), Key otherwise
+    template<class Hasher, class KeyEql>
+    using lookup_key = typename std::conditional<is_transparent<Hasher>::value && is_transparent<KeyEql>::value, lookup_any_, lookup_exact_>::type;
+
+    template <class Key, class Hasher, class KeyEql>
+    class
+#if defined(_MSC_VER) && _MSC_VER >= 1915
+        __declspec (empty_bases)
+#endif
+    hash_eql: private Hasher, private KeyEql
+    {
+    public:
+        hash_eql() {}
+        hash_eql(const Hasher& h, const KeyEql& eql) :Hasher(h), KeyEql(eql) {}
+        hash_eql(const hash_eql& r) : Hasher(r), KeyEql(r) {}
+        hash_eql(hash_eql&& r) noexcept : Hasher(std::move(r)), KeyEql(std::move(r)) {}
+
+        hash_eql& operator=(const hash_eql& r) {
+            hash_eql(r).swap(*this);
+            return *this;
+        }
+
+        hash_eql& operator=(hash_eql&& r) noexcept {
+            const_cast<Hasher&>(hasher()) = std::move(r);
+            const_cast<KeyEql&>(keyeql()) = std::move(r);
+            return *this;
+        }
+
+        template<typename K>
+        HRD_ALWAYS_INLINE size_t operator()(const K& k) const { return static_cast<size_t>(hasher()(k)); }
+        template<typename K1, typename K2>
+        HRD_ALWAYS_INLINE bool operator()(const K1& k1, const K2& k2) const { return keyeql()(k1, k2); }
+
+        void swap(hash_eql& r) noexcept {
+            std::swap(const_cast<Hasher&>(hasher()), const_cast<Hasher&>(r.hasher()));
+            std::swap(const_cast<KeyEql&>(keyeql()), const_cast<KeyEql&>(r.keyeql()));
+        }
+
+    private:
+        HRD_ALWAYS_INLINE const Hasher& hasher() const noexcept { return *this; }
+        HRD_ALWAYS_INLINE const KeyEql& keyeql() const noexcept { return *this; }
+    };
+
+protected:
+    /**
+     * Control byte of every slot: H2 (low 7 bits of hash) if used, EMPTY_CTRL/DELETED_CTRL otherwise.
+     * Control array is "_capacity + GROUP_WIDTH" bytes: slots [0, _capacity), SENTINEL_CTRL at _capacity (stops iteration),
+     * then clones of first GROUP_WIDTH - 1 bytes, so a group loaded from any slot never wraps.
+     */
+    enum : int8_t { EMPTY_CTRL = -128, DELETED_CTRL = -2, SENTINEL_CTRL = -1 };
+
+    static constexpr size_t GROUP_WIDTH = 16;
+    static constexpr size_t MIN_POW2 = 16; //group never covers a slot twice
+
+    struct group
+    {
+        HRD_ALWAYS_INLINE explicit group(const int8_t* p) noexcept : _v(_mm_loadu_si128((const __m128i*)p)) {}
+
+        HRD_ALWAYS_INLINE uint32_t match(int8_t h2) const noexcept {
+            return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_v, _mm_set1_epi8(h2)));
+        }
+
+        HRD_ALWAYS_INLINE uint32_t match_empty() const noexcept {
+            return match(EMPTY_CTRL);
+        }
+
+        HRD_ALWAYS_INLINE uint32_t match_empty_or_deleted() const noexcept {
+            return (uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(SENTINEL_CTRL), _v));
+        }
+
+        //free slots before the first used one or sentinel
+        HRD_ALWAYS_INLINE size_t count_leading_empty_or_deleted() const noexcept {
+            return ctz(match_empty_or_deleted() + 1);
+        }
+
+        __m128i _v;
+    };
+
+    HRD_ALWAYS_INLINE static size_t ctz(uint32_t v) noexcept {
+#ifdef _MSC_VER
+        unsigned long idx;
+        _BitScanForward(&idx, v);
+        return idx;
+#else
+        return __builtin_ctz(v);
+#endif
+    }
+
+    //leading zeros of 16 bits group mask, v != 0
+    HRD_ALWAYS_INLINE static size_t clz16(uint32_t v) noexcept {
+#ifdef _MSC_VER
+        unsigned long idx;
+        _BitScanReverse(&idx, v);
+        return 15 - idx;
+#else
+        return __builtin_clz(v) - 16;
+#endif
+    }
+
+    HRD_ALWAYS_INLINE static size_t h1(size_t h) noexcept { return h >> 7; }
+    HRD_ALWAYS_INLINE static int8_t h2(size_t h) noexcept { return (int8_t)(h & 0x7F); }
+
+    //control array length rounded up to slots alignment
+    template<typename this_type>
+    HRD_ALWAYS_INLINE constexpr static size_t ctrl_size(size_t capacity) noexcept {
+        return (capacity + GROUP_WIDTH + (alignof(typename this_type::storage_type) > 16 ? alignof(typename this_type::storage_type) : 16) - 1) &
+            ~((alignof(typename this_type::storage_type) > 16 ? alignof(typename this_type::storage_type) : 16) - 1);
+    }
+
+    //control array of table without storage: one group with sentinel, any lookup stops there
+    static int8_t* empty_ctrl() noexcept {
+        alignas(16) static const int8_t ctrl[GROUP_WIDTH] = { SENTINEL_CTRL,
+            EMPTY_CTRL, EMPTY_CTRL, EMPTY_CTRL, EMPTY_CTRL, EMPTY_CTRL, EMPTY_CTRL, EMPTY_CTRL, EMPTY_CTRL,
+            EMPTY_CTRL, EMPTY_CTRL, EMPTY_CTRL, EMPTY_CTRL, EMPTY_CTRL, EMPTY_CTRL, EMPTY_CTRL };
+        return const_cast<int8_t*>(ctrl);
+    }
+
+    template<class T>
+    struct StorageItem
+    {
+        StorageItem(StorageItem&& r) : data(std::move(r.data)) {}
+        StorageItem(const StorageItem& r) : data(r.data) {}
+
+        T data;
+    };
+
+    constexpr static const uint32_t OFFSET_BASIS = 2166136261;
+
+    //if any exception happens during any new-in-place call ::dtor
+    template<typename this_type>
+    class dtor_if_throw_constructible {
+    public:
+        inline dtor_if_throw_constructible(this_type& ref) noexcept { set(&ref, typename this_type::IS_NOTHROW_CONSTRUCTIBLE()); }
+        inline ~dtor_if_throw_constructible() noexcept { clear(typename this_type::IS_NOTHROW_CONSTRUCTIBLE()); }
+
+        inline void reset() noexcept { set(nullptr, typename this_type::IS_NOTHROW_CONSTRUCTIBLE()); }
+    private:
+        inline void set(this_type*, std::true_type) noexcept {}
+        inline void set(this_type* ptr, std::false_type) noexcept { _this = ptr; }
+        inline void clear(std::true_type) noexcept {}
+        inline void clear(std::false_type) noexcept { if (_this) dtor(); }
+        HRD_ATTR_NOINLINE void dtor() noexcept { _this->dtor(typename this_type::IS_TRIVIALLY_DESTRUCTIBLE(), _this); }
+        this_type* _this;
+    };
+
+    template<size_t SIZE>
+    static size_t hash_1(const void* ptr) noexcept {
+        return umul128(fnv_1a((const char*)ptr, SIZE), 0xde5fb9d2630458e9ull);
+    }
+
+    constexpr static HRD_ALWAYS_INLINE uint32_t fnv_1a(const char* key, size_t len, uint32_t hash32 = OFFSET_BASIS) noexcept
+    {
+        constexpr const uint32_t PRIME = 1607;
+
+        for (size_t cnt = len / sizeof(uint32_t); cnt--; key += sizeof(uint32_t))
+            hash32 = (hash32 ^ (*(uint32_t*)key)) * PRIME;
+
+        if (len & sizeof(uint16_t)) {
+            hash32 = (hash32 ^ (*(uint16_t*)key)) * PRIME;
+            key += sizeof(uint16_t);
+        }
+        if (len & 1)
+            hash32 = (hash32 ^ (*key)) * PRIME;
+
+        return hash32 ^ (hash32 >> 16);
+    }
+
+#ifdef _MSC_VER
+    HRD_ALWAYS_INLINE static uint64_t umul128(uint64_t a, uint64_t b) noexcept {
+        uint64_t h, l = _umul128(a, b, &h);
+        return l + h;
+    }
+#else
+    HRD_ALWAYS_INLINE static uint64_t umul128(uint64_t a, uint64_t b) noexcept {
+        typedef unsigned __int128 uint128_t;
+
+        auto result = static_cast<uint128_t>(a) * static_cast<uint128_t>(b);
+        return static_cast<uint64_t>(result) + static_cast<uint64_t>(result >> 64U);
+    }
+#endif
+
+    template<class this_type>
+    HRD_ALWAYS_INLINE typename this_type::storage_type* slots_() const noexcept {
+        return reinterpret_cast<typename this_type::storage_type*>(_elements + ctrl_size<this_type>(_capacity));
+    }
+
+    //control byte of slot i and its clone
+    HRD_ALWAYS_INLINE void set_ctrl_(size_t i, int8_t c) noexcept {
+        _elements[i] = c;
+        _elements[((i - (GROUP_WIDTH - 1)) & _capacity) + (GROUP_WIDTH - 1)] = c;
+    }
+
+    //first EMPTY_CTRL/DELETED_CTRL slot of the probe sequence
+    HRD_ALWAYS_INLINE size_t first_non_full_(size_t h) const noexcept
+    {
+        size_t pos = h1(h) & _capacity;
+        for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+            if (uint32_t free = group(_elements + pos).match_empty_or_deleted())
+                return (pos + ctz(free)) & _capacity;
+            pos = (pos + step) & _capacity;
+        }
+    }
+
+    //index of the element equal to k or SIZE_MAX if absent
+    template<typename key_type, class this_type>
+    HRD_ALWAYS_INLINE size_t find_pos_(const key_type& k, size_t h, const this_type& ref) const noexcept
+    {
+        auto* ee = slots_<this_type>();
+        const int8_t c = h2(h);
+        size_t pos = h1(h) & _capacity;
+        for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH)
+        {
+            group g(_elements + pos);
+            for (uint32_t m = g.match(c); m; m &= m - 1) {
+                size_t i = (pos + ctz(m)) & _capacity;
+                if (HRD_LIKELY(ref(this_type::key_getter::get_key(ee[i].data), k))) //identical found
+                    return i;
+            }
+            if (HRD_LIKELY(g.match_empty()))
+                return SIZE_MAX;
+            pos = (pos + step) & _capacity;
+        }
+    }
+
+    //space must be allocated before
+    template<typename this_type, typename V>
+    HRD_ALWAYS_INLINE void insert_unique(V&& st, const this_type& ref, typename this_type::storage_type* this_elements)
+    {
+        typedef typename std::remove_reference<V>::type storage_type;
+
+        size_t h = ref(this_type::key_getter::get_key(st.data));
+        size_t i = first_non_full_(h);
+        new ((void*)(this_elements + i)) storage_type(std::forward<V>(st));
+        set_ctrl_(i, h2(h));
+        _size++;
+    }
+
+    template<typename this_type>
+    void resize_pow2(size_t pow2, const this_type& ref)
+    {
+        this_type tmp(pow2, false);
+        if (HRD_LIKELY(_size)) //rehash
+        {
+            auto* src_ee = slots_<this_type>();
+            auto* dst_ee = tmp.template slots_<this_type>();
+
+            for (size_t i = 0;; ++i)
+            {
+                if (_elements[i] >= 0) {
+                    typedef typename this_type::value_type VT;
+
+                    VT& r = src_ee[i].data;
+                    tmp.insert_unique(std::move(src_ee[i]), ref, dst_ee);
+                    r.~VT();
+
+                    //next 2 lines to cover any exception that occurs during next tmp.insert_unique(std::move(r));
+                    set_ctrl_(i, DELETED_CTRL);
+                    _erased++;
+
+                    if (!--_size)
+                        break;
+                }
+            }
+            _size = tmp._size;
+            tmp._size = 0; //prevent elements dtor call
+        }
+        std::swap(_capacity, tmp._capacity);
+        std::swap(_elements, tmp._elements);
+        _erased = 0;
+    }
+
+    //pow2 keeping "size" elements under load limit
+    HRD_ALWAYS_INLINE static size_t calc_pow2(size_t size) noexcept
+    {
+        size_t pow2 = MIN_POW2;
+        while (gap_(pow2 - 1) < size)
+            pow2 <<= 1;
+        return pow2;
+    }
+
+    //max used (with DELETED_CTRL) slots count, 7/8 of capacity
+    HRD_ALWAYS_INLINE constexpr static size_t gap_(size_t capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+
+    HRD_ATTR_NOINLINE HRD_ATTR_NORETURN static void throw_bad_alloc() {
+        throw std::bad_alloc();
+    }
+
+    HRD_ATTR_NOINLINE HRD_ATTR_NORETURN static void throw_length_error() {
+        throw std::length_error("size exceeded");
+    }
+
+    template<typename base>
+    struct iterator_base
+    {
+        class const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef typename base::value_type value_type;
+            typedef typename base::value_type* pointer;
+            typedef typename base::value_type& reference;
+            typedef std::ptrdiff_t difference_type;
+
+            const_iterator() noexcept : _mark(nullptr), _ptr(nullptr) {}
+
+            HRD_ALWAYS_INLINE const_iterator& operator++() noexcept
+            {
+                ++_mark;
+                ++_ptr;
+                skip_free();
+                return *this;
+            }
+
+            HRD_ALWAYS_INLINE const_iterator operator++(int) noexcept
+            {
+                const_iterator ret(*this);
+                ++(*this);
+                return ret;
+            }
+
+            bool operator== (const const_iterator& r) const noexcept { return _ptr == r._ptr; }
+            bool operator!= (const const_iterator& r) const noexcept { return _ptr != r._ptr; }
+
+            const typename base::value_type& operator*() const noexcept { return _ptr->data; }
+            const typename base::value_type* operator->() const noexcept { return &_ptr->data; }
+
+        protected:
+            friend base;
+            friend hash_base;
+            const_iterator(typename base::storage_type* p, int8_t* mark) noexcept : _mark(mark), _ptr(p) {}
+
+            //move to the first used slot from the current one, end() at sentinel
+            HRD_ALWAYS_INLINE void skip_free() noexcept
+            {
+                while (*_mark < SENTINEL_CTRL) {
+                    size_t shift = group(_mark).count_leading_empty_or_deleted();
+                    _mark += shift;
+                    _ptr += shift;
+                }
+                if (HRD_UNLIKELY(*_mark == SENTINEL_CTRL))
+                    _ptr = nullptr;
+            }
+
+            int8_t* _mark;
+            typename base::storage_type* _ptr;
+        };
+
+        class iterator : public const_iterator
+        {
+        public:
+            using typename const_iterator::iterator_category;
+            using typename const_iterator::value_type;
+            using typename const_iterator::pointer;
+            using typename const_iterator::reference;
+            using typename const_iterator::difference_type;
+            using const_iterator::operator*;
+            using const_iterator::operator->;
+
+            iterator() noexcept {}
+
+            typename base::value_type& operator*() noexcept { return const_iterator::_ptr->data; }
+            typename base::value_type* operator->() noexcept { return &const_iterator::_ptr->data; }
+
+        private:
+            friend base;
+            friend hash_base;
+            iterator(typename base::storage_type* p, int8_t* mark) : const_iterator(p, mark) {}
+        };
+    };
+
+    template<typename this_type>
+    HRD_ALWAYS_INLINE void ctor_copy(std::true_type, const this_type& ref) //IS_TRIVIALLY_COPYABLE
+    {
+        typedef typename this_type::storage_type StorageType;
+
+        if (HRD_LIKELY(ref._size))
+        {
+            size_t len = ctrl_size<this_type>(ref._capacity) + (ref._capacity + 1) * sizeof(StorageType);
+            _elements = (int8_t*)malloc(len);
+            if (HRD_LIKELY(!!_elements)) {
+                memcpy(_elements, ref._elements, len);
+                _size = ref._size;
+                _capacity = ref._capacity;
+                _erased = ref._erased;
+            }
+            else {
+                throw_bad_alloc();
+            }
+        }
+        else
+            ctor_empty();
+    }
+
+    template<typename this_type>
+    HRD_ALWAYS_INLINE void ctor_copy_1(std::true_type, const this_type& ref) //IS_NOTHROW_CONSTRUCTIBLE
+    {
+        size_t cnt = ref._size;
+
+        auto* dst_ee = slots_<this_type>();
+        auto* src_ee = ref.template slots_<this_type>();
+
+        for (size_t i = 0;; ++i)
+        {
+            if (ref._elements[i] >= 0) {
+                insert_unique(src_ee[i], ref, dst_ee);
+                if (HRD_UNLIKELY(!--cnt))
+                    break;
+            }
+        }
+    }
+
+    template<typename this_type>
+    HRD_ALWAYS_INLINE void ctor_copy_1(std::false_type, const this_type& ref) //IS_NOTHROW_CONSTRUCTIBLE == false
+    {
+        dtor_if_throw_constructible<this_type> tmp(*reinterpret_cast<this_type*>(this));
+        ctor_copy_1(std::true_type(), ref);
+
+        tmp.reset();
+    }
+
+    template<typename this_type>
+    HRD_ALWAYS_INLINE void ctor_copy(std::false_type, const this_type& ref) //IS_TRIVIALLY_COPYABLE
+    {
+        if (HRD_LIKELY(ref._size)) {
+            ctor_pow2<this_type>(ref._capacity + 1);
+            ctor_copy_1(typename this_type::IS_NOTHROW_CONSTRUCTIBLE(), ref);
+        }
+        else
+            ctor_empty();
+    }
+
+    HRD_ALWAYS_INLINE void ctor_move(hash_base&& r) noexcept
+    {
+        memcpy(this, &r, sizeof(hash_base));
+        r.ctor_empty();
+    }
+
+#if (__cplusplus >= 201402L || _MSC_VER > 1600 || __clang__)
+    template<typename this_type>
+    HRD_ALWAYS_INLINE void ctor_init_list(std::initializer_list<typename this_type::value_type> lst, this_type& ref)
+    {
+        ctor_pow2<this_type>(calc_pow2(lst.size()));
+        dtor_if_throw_constructible<this_type> tmp(ref);
+        insert_iters_(lst.begin(), lst.end(), ref);
+
+        tmp.reset();
+    }
+#endif
+
+    template<typename Iter, class this_type>
+    HRD_ALWAYS_INLINE void ctor_iters(Iter first, Iter last, this_type& ref, std::random_access_iterator_tag)
+    {
+        ctor_pow2<this_type>(calc_pow2(std::distance(first, last)));
+        dtor_if_throw_constructible<this_type> tmp(ref);
+        insert_iters_(first, last, ref);
+
+        tmp.reset();
+    }
+
+    template<typename Iter, class this_type, typename XXX>
+    HRD_ALWAYS_INLINE void ctor_iters(Iter first, Iter last, this_type& ref, XXX)
+    {
+        dtor_if_throw_constructible<this_type> tmp(ref);
+        ctor_empty();
+        insert_iters_(first, last, ref);
+
+        tmp.reset();
+    }
+
+    template <typename Iter, class this_type>
+    void insert_iters_(Iter first, Iter last, this_type& ref) {
+        for (; first != last; ++first)
+            insert_(*first, ref);
+    }
+
+    template<typename Iter, class this_type>
+    HRD_ALWAYS_INLINE void insert_iters(Iter first, Iter last, this_type& ref, std::random_access_iterator_tag)
+    {
+        size_t actual = std::distance(first, last) + _size;
+        if ((_erased + actual) >= gap_(_capacity))
+            resize_pow2(calc_pow2(actual), ref);
+
+        insert_iters_(first, last, ref);
+    }
+
+    template<typename Iter, class this_type, typename XXX>
+    HRD_ALWAYS_INLINE void insert_iters(Iter first, Iter last, this_type& ref, XXX) {
+        insert_iters_(first, last, ref);
+    }
+
+    HRD_ALWAYS_INLINE void ctor_empty() noexcept
+    {
+        _size = 0;
+        _capacity = 0;
+        _elements = empty_ctrl(); //never written: insert into table without storage allocates first
+        _erased = 0;
+    }
+
+    template<class this_type>
+    HRD_ALWAYS_INLINE void ctor_pow2(size_t pow2)
+    {
+        if (pow2 < MIN_POW2)
+            pow2 = MIN_POW2;
+        _size = 0;
+        _capacity = pow2 - 1;  //-1 for performance in lookup-function, also count of usable slots (sentinel takes the last one)
+        _erased = 0;
+        size_t bt_size = ctrl_size<this_type>(_capacity);
+        _elements = (int8_t*)malloc(bt_size + sizeof(typename this_type::storage_type) * pow2);
+        if (HRD_UNLIKELY(!_elements))
+            throw_bad_alloc();
+        memset(_elements, EMPTY_CTRL, bt_size);
+        _elements[_capacity] = SENTINEL_CTRL;
+    }
+
+    template<class this_type>
+    HRD_ALWAYS_INLINE void dtor(std::true_type, this_type*) noexcept
+    {
+        if (HRD_LIKELY(_capacity))
+            free(_elements);
+    }
+
+    template<class this_type>
+    HRD_ALWAYS_INLINE void dtor(std::false_type, this_type*) noexcept
+    {
+        if (auto cnt = _size)
+        {
+            typedef typename this_type::value_type data_type;
+
+            auto* ee = slots_<this_type>();
+            for (size_t i = 0;; ++i)
+            {
+                if (_elements[i] >= 0) {
+                    ee[i].data.~data_type();
+                    if (HRD_UNLIKELY(!--cnt))
+                        break;
+                }
+            }
+        }
+        if (_capacity)
+            free(_elements);
+    }
+
+    template<class this_type>
+    HRD_ALWAYS_INLINE void clear(std::true_type) noexcept
+    {
+        if (HRD_LIKELY(_capacity)) {
+            free(_elements);
+            ctor_empty();
+        }
+    }
+
+    template<class this_type>
+    HRD_ALWAYS_INLINE void clear(std::false_type) noexcept {
+        dtor(std::false_type(), (this_type*)nullptr);
+        ctor_empty();
+    }
+
+    //no room for one more element: double capacity or only purge DELETED_CTRL if they are the most of used slots
+    template<class this_type>
+    HRD_ALWAYS_INLINE void grow_(const this_type& ref)
+    {
+        size_t gap = gap_(_capacity);
+        resize_pow2((_size * 2 >= gap) ? 2 * (_capacity + 1) : (_capacity + 1), ref);
+    }
+
+    //slot of the element equal to k (second = false) or free slot to construct it in (second = true)
+    template<typename key_type, class this_type>
+    HRD_ALWAYS_INLINE std::pair<size_t, bool> prepare_insert_(const key_type& k, size_t h, const this_type& ref)
+    {
+        if (HRD_UNLIKELY(_size + _erased >= gap_(_capacity)))
+            grow_(ref);
+
+        size_t i = find_pos_(k, h, ref);
+        if (i != SIZE_MAX) //identical found
+            return std::pair<size_t, bool>(i, false);
+
+        return std::pair<size_t, bool>(first_non_full_(h), true);
+    }
+
+    //element is constructed in slot i
+    HRD_ALWAYS_INLINE void commit_insert_(size_t i, size_t h) noexcept
+    {
+        if (HRD_UNLIKELY(_elements[i] == DELETED_CTRL)) _erased--;
+        set_ctrl_(i, h2(h));
+        _size++;
+    }
+
+    template<typename V, class this_type>
+    HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, this_type& ref) {
+        return insert_(std::forward<V>(val), ref(this_type::key_getter::get_key(val)), ref);
+    }
+
+    //h - hash of val key
+    template<typename V, class this_type>
+    HRD_ALWAYS_INLINE std::pair<typename this_type::iterator, bool> insert_(V&& val, size_t h, this_type& ref)
+    {
+        typedef typename this_type::iterator iter;
+        typedef typename this_type::value_type value_type;
+
+        std::pair<size_t, bool> p = prepare_insert_(this_type::key_getter::get_key(val), h, ref);
+
+        auto* ee = slots_<this_type>();
+        if (p.second) {
+            new ((void*)&ee[p.first].data) value_type(std::forward<V>(val));
+            commit_insert_(p.first, h);
+        }
+        return std::pair<iter, bool>(iter(ee + p.first, _elements + p.first), p.second);
+    }
+
+    template<typename key_type, class this_type>
+    HRD_ALWAYS_INLINE typename this_type::storage_type* find_(const key_type& k, size_t h, const this_type& ref) const noexcept
+    {
+        size_t i = find_pos_(k, h, ref);
+        return (i != SIZE_MAX) ? slots_<this_type>() + i : nullptr;
+    }
+
+    template<typename key_type, class this_type>
+    HRD_ALWAYS_INLINE typename this_type::iterator find_iter_(const key_type& k, size_t h, const this_type& ref) const noexcept
+    {
+        typedef typename this_type::iterator iter;
+
+        size_t i = find_pos_(k, h, ref);
+        return (i != SIZE_MAX) ? iter(slots_<this_type>() + i, _elements + i) : iter();
+    }
+
+    //EMPTY_CTRL if no probe sequence passed full group around slot i, DELETED_CTRL otherwise
+    HRD_ALWAYS_INLINE void free_slot_(size_t i) noexcept
+    {
+        uint32_t empty_before = group(_elements + ((i - GROUP_WIDTH) & _capacity)).match_empty();
+        uint32_t empty_after = group(_elements + i).match_empty();
+        if (empty_before && empty_after && ctz(empty_after) + clz16(empty_before) < GROUP_WIDTH)
+            set_ctrl_(i, EMPTY_CTRL);
+        else {
+            set_ctrl_(i, DELETED_CTRL);
+            _erased++;
+        }
+    }
+
+    template <class this_type>
+    HRD_ALWAYS_INLINE typename this_type::iterator erase_(typename this_type::const_iterator& it) noexcept
+    {
+        typename this_type::iterator& ret = (typename this_type::iterator&)it;
+
+        if (HRD_LIKELY(!!it._ptr)) //valid
+        {
+            typedef typename this_type::value_type data_type;
+
+            it._ptr->data.~data_type();
+            _size--;
+            free_slot_(it._mark - _elements);
+            ++ret;
+        }
+        return ret;
+    }
+
+    template <typename key_type, class this_type>
+    HRD_ALWAYS_INLINE size_type erase_(const key_type& k, size_t h, this_type& ref) noexcept
+    {
+        size_t i = find_pos_(k, h, ref);
+        if (i == SIZE_MAX)
+            return 0;
+
+        typedef typename this_type::value_type data_type;
+
+        slots_<this_type>()[i].data.~data_type();
+        _size--;
+        free_slot_(i);
+        return 1;
+    }
+
+    template <class this_type>
+    HRD_ALWAYS_INLINE typename this_type::iterator begin_() noexcept
+    {
+        if (_size) {
+            typename this_type::iterator ret(slots_<this_type>(), _elements);
+            ret.skip_free();
+            return ret;
+        }
+        return typename this_type::iterator();
+    }
+
+    template<class this_type>
+    void shrink_to_fit(const this_type& ref)
+    {
+        if (HRD_LIKELY(_size)) {
+            size_t pow2 = calc_pow2(_size);
+            if (HRD_LIKELY(_erased || (_capacity + 1) != pow2))
+                resize_pow2(pow2, ref);
+        }
+        else {
+            clear<this_type>(std::true_type());
+        }
+    }
+
+    HRD_ALWAYS_INLINE void swap(hash_base& r) noexcept
+    {
+        std::swap(_size, r._size);
+        std::swap(_capacity, r._capacity);
+        std::swap(_elements, r._elements);
+        std::swap(_erased, r._erased);
+    }
+
+    size_type _size;
+    size_type _capacity;
+    int8_t* _elements;
+    size_type _erased;
+};
+
+template<>
+HRD_ALWAYS_INLINE size_t hash_base::hash_1<4>(const void* ptr) noexcept {
+    return umul128(*(uint32_t*)ptr, 0xde5fb9d2630458e9ull);
+}
+
+template<>
+HRD_ALWAYS_INLINE size_t hash_base::hash_1<8>(const void* ptr) noexcept {
+    return umul128(*(uint64_t*)ptr, 0xde5fb9d2630458e9ull);
+}
+
+#if __cplusplus >= 201703L
+template<>
+struct hash_base::hash_<std::string_view> {
+    typedef void is_transparent;
+
+    HRD_ALWAYS_INLINE size_t operator()(std::string_view val) const noexcept {
+        return hash_base::umul128(hash_base::fnv_1a(val.data(), val.size()), 0xde5fb9d2630458e9ull);
+    }
+};
+
+//std::string, std::string_view and const char* of the same text hash equally: with std::equal_to<> std::string table is searched by any of them
+template<>
+struct hash_base::hash_<std::string> : public hash_base::hash_<std::string_view> {};
+#else
+template<>
+struct hash_base::hash_<std::string> {
+    HRD_ALWAYS_INLINE size_t operator()(const std::string& val) const noexcept {
+        return hash_base::umul128(hash_base::fnv_1a(val.c_str(), val.size()), 0xde5fb9d2630458e9ull);
+    }
+};
+#endif
+
+//----------------------------------------- hash_set -----------------------------------------
+
+template<class Key, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>>
+class hash_set : public hash_base, private hash_base::hash_eql<Key, Hash, Pred>
+{
+public:
+    typedef hash_set<Key, Hash, Pred>   this_type;
+    typedef Key                         key_type;
+    typedef Hash                        hasher;
+    typedef Pred                        key_equal;
+    typedef const key_type              value_type;
+    typedef value_type&                 reference;
+    typedef const value_type&           const_reference;
+
+private:
+    friend iterator_base<this_type>;
+    friend hash_base;
+    typedef StorageItem<key_type>       storage_type;
+    typedef hash_eql<Key, Hash, Pred>   hash_pred;
+
+#if (__cplusplus >= 201402L || _MSC_VER > 1600 || __clang__)
+    typedef std::is_trivially_copyable<key_type> IS_TRIVIALLY_COPYABLE;
+    typedef std::is_trivially_destructible<key_type> IS_TRIVIALLY_DESTRUCTIBLE;
+    typedef std::is_nothrow_constructible<key_type> IS_NOTHROW_CONSTRUCTIBLE;
+#else
+    typedef std::is_pod<key_type> IS_TRIVIALLY_COPYABLE;
+    typedef std::is_pod<key_type> IS_TRIVIALLY_DESTRUCTIBLE;
+    typedef std::is_pod<key_type> IS_NOTHROW_CONSTRUCTIBLE;
+#endif
+
+    struct key_getter {
+        HRD_ALWAYS_INLINE static const key_type& get_key(const value_type& r) noexcept {
+            return r;
+        }
+        HRD_ALWAYS_INLINE static const key_type& get_key(const storage_type& r) noexcept {
+            return r.data;
+        }
+    };
+
+public:
+    typedef typename iterator_base<this_type>::iterator iterator;
+    typedef typename iterator_base<this_type>::const_iterator const_iterator;
+
+    //key type of lookups, see hash_base::lookup_key
+    template<class K>
+    using key_arg = typename lookup_key<Hash, Pred>::template type<K, key_type>;
+
+    hash_set() {
+        ctor_empty();
+    }
+
+    hash_set(const hash_set& r) :
+        hash_pred(r)
+    {
+        ctor_copy(IS_TRIVIALLY_COPYABLE(), r);
+    }
+
+    hash_set(hash_set&& r) noexcept :
+        hash_pred(std::move(r))
+    {
+        ctor_move(std::move(r));
+    }
+
+    hash_set(size_type hint_size, const hasher& hf = hasher(), const key_equal& eql = key_equal()) :
+        hash_pred(hf, eql)
+    {
+        ctor_pow2<this_type>(calc_pow2(hint_size));
+    }
+
+    template<typename Iter>
+    hash_set(Iter first, Iter last, const hasher& hf = hasher(), const key_equal& eql = key_equal()) :
+        hash_pred(hf, eql)
+    {
+        ctor_iters(first, last, *this, typename std::iterator_traits<Iter>::iterator_category());
+    }
+
+#if (__cplusplus >= 201402L || _MSC_VER > 1600 || __clang__)
+    hash_set(std::initializer_list<value_type> lst, const hasher& hf = hasher(), const key_equal& eql = key_equal()) :
+        hash_pred(hf, eql)
+    {
+        ctor_init_list(lst, *this);
+    }
+#endif
+
+    ~hash_set() {
+        hash_base::dtor(IS_TRIVIALLY_DESTRUCTIBLE(), this);
+    }
+
+    static constexpr size_type max_size() noexcept {
+        return (size_type(1) << (sizeof(size_type) * 8 - 1)) / (sizeof(storage_type) + 1);
+    }
+
+    iterator begin() noexcept {
+        return begin_<this_type>();
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_cast<this_type*>(this)->begin();
+    }
+
+    iterator end() noexcept {
+        return iterator();
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator();
+    }
+
+    void reserve(size_type hint) {
+        if (HRD_LIKELY(hint > gap_(_capacity) - _erased))
+            resize_pow2(calc_pow2(hint), *this);
+    }
+
+    void clear() noexcept {
+        hash_base::clear<this_type>(IS_TRIVIALLY_DESTRUCTIBLE());
+    }
+
+    void swap(hash_set& r) noexcept {
+        hash_base::swap(r);
+        hash_pred::swap(r);
+    }
+
+    /*! Can invalidate iterators. */
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(const key_type& val) {
+        return insert_(val, *this);
+    }
+
+    /*! Can invalidate iterators. */
+    template<class P>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(P&& val) {
+        return insert_(std::forward<P>(val), *this);
+    }
+
+    template<typename Iter>
+    HRD_ALWAYS_INLINE void insert(Iter first, Iter last) {
+        insert_iters(first, last, *this, typename std::iterator_traits<Iter>::iterator_category());
+    }
+
+#if (__cplusplus >= 201402L || _MSC_VER > 1600 || __clang__)
+    /*! Can invalidate iterators. */
+    void insert(std::initializer_list<value_type> lst) {
+        insert_iters(lst.begin(), lst.end(), *this, std::random_access_iterator_tag());
+    }
+#endif
+
+    /*! Can invalidate iterators. */
+    template<class K>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace(K&& val) {
+        return insert_(std::forward<K>(val), *this);
+    }
+
+    /*! Can invalidate iterators.
+    * \params hash - hash of val computed before by hasher, the same key looked up in several tables is hashed once
+    */
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(const key_type& val, size_t hash) {
+        return insert_(val, hash, *this);
+    }
+
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(key_type&& val, size_t hash) {
+        return insert_(std::move(val), hash, *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE iterator find(const key_arg<K>& k) noexcept {
+        return find_iter_(k, hash_pred::operator()(k), *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE const_iterator find(const key_arg<K>& k) const noexcept {
+        return find_iter_(k, hash_pred::operator()(k), *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type count(const key_arg<K>& k) const noexcept {
+        return find_(k, hash_pred::operator()(k), *this) != nullptr;
+    }
+
+    //lookups by hash of k computed before, see insert(val, hash)
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE iterator find(const key_arg<K>& k, size_t hash) noexcept {
+        return find_iter_(k, hash, *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE const_iterator find(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_iter_(k, hash, *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type count(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash, *this) != nullptr;
+    }
+
+    /*! Doesn't invalidate iterators.
+    * \params it - Iterator pointing to a single element to be removed
+    * \return an iterator pointing to the position immediately following of the element erased
+    */
+    inline iterator erase(const_iterator it) noexcept {
+        return erase_<this_type>(it);
+    }
+
+    //exact match for iterator argument, erase(key_arg<K>) of transparent table takes it otherwise
+    HRD_ALWAYS_INLINE iterator erase(iterator it) noexcept {
+        return erase(const_iterator(it));
+    }
+
+    /*! Doesn't invalidate iterators.
+    * \params k - Key of the element to be erased
+    * \return 1 - if element erased and zero otherwise
+    */
+    template<class K = key_type>
+    inline size_type erase(const key_arg<K>& k) noexcept {
+        return erase_(k, hash_pred::operator()(k), *this);
+    }
+
+    template<class K = key_type>
+    inline size_type erase(const key_arg<K>& k, size_t hash) noexcept {
+        return erase_(k, hash, *this);
+    }
+
+    void shrink_to_fit() {
+        hash_base::shrink_to_fit<this_type>(*this);
+    }
+
+    HRD_ALWAYS_INLINE hash_set& operator=(const hash_set& r) {
+        this_type(r).swap(*this);
+        return *this;
+    }
+
+    HRD_ALWAYS_INLINE hash_set& operator=(hash_set&& r) noexcept {
+        swap(r);
+        return *this;
+    }
+
+private:
+    hash_set(size_type pow2, bool) {
+        ctor_pow2<this_type>(pow2);
+    }
+};
+
+//----------------------------------------- hash_map -----------------------------------------
+
+template<class Key, class T, class Hash = hash_base::hash_<Key>, class Pred = std::equal_to<Key>>
+class hash_map : public hash_base, private hash_base::hash_eql<Key, Hash, Pred>
+{
+public:
+    typedef hash_map<Key, T, Hash, Pred>            this_type;
+    typedef Key                                     key_type;
+    typedef T                                       mapped_type;
+    typedef Hash                                    hasher;
+    typedef Pred                                    key_equal;
+    typedef std::pair<const key_type, mapped_type>  value_type;
+    typedef value_type&                             reference;
+    typedef const value_type&                       const_reference;
+
+private:
+    friend iterator_base<this_type>;
+    friend hash_base;
+    typedef StorageItem<value_type>     storage_type;
+    typedef hash_eql<Key, Hash, Pred>   hash_pred;
+
+#if (__cplusplus >= 201402L || _MSC_VER > 1600 || __clang__)
+    typedef std::integral_constant<bool, std::is_trivially_copyable<key_type>::value && std::is_trivially_copyable<mapped_type>::value> IS_TRIVIALLY_COPYABLE;
+    typedef std::integral_constant<bool, std::is_trivially_destructible<key_type>::value && std::is_trivially_destructible<mapped_type>::value> IS_TRIVIALLY_DESTRUCTIBLE;
+    typedef std::integral_constant<bool, std::is_nothrow_constructible<key_type>::value && std::is_nothrow_constructible<mapped_type>::value> IS_NOTHROW_CONSTRUCTIBLE;
+#else
+    typedef std::integral_constant<bool, std::is_pod<key_type>::value && std::is_pod<mapped_type>::value> IS_TRIVIALLY_COPYABLE;
+    typedef std::integral_constant<bool, std::is_pod<key_type>::value && std::is_pod<mapped_type>::value> IS_TRIVIALLY_DESTRUCTIBLE;
+    typedef std::integral_constant<bool, std::is_pod<key_type>::value && std::is_pod<mapped_type>::value> IS_NOTHROW_CONSTRUCTIBLE;
+#endif
+
+    struct key_getter {
+        HRD_ALWAYS_INLINE static const key_type& get_key(const value_type& r) noexcept {
+            return r.first;
+        }
+        HRD_ALWAYS_INLINE static const key_type& get_key(const storage_type& r) noexcept {
+            return r.data.first;
+        }
+    };
+
+public:
+    typedef typename iterator_base<this_type>::iterator iterator;
+    typedef typename iterator_base<this_type>::const_iterator const_iterator;
+
+    //key type of lookups, see hash_base::lookup_key
+    template<class K>
+    using key_arg = typename lookup_key<Hash, Pred>::template type<K, key_type>;
+
+    hash_map() {
+        ctor_empty();
+    }
+
+    hash_map(const hash_map& r) :
+        hash_pred(r)
+    {
+        ctor_copy(IS_TRIVIALLY_COPYABLE(), r);
+    }
+
+    hash_map(hash_map&& r) noexcept :
+        hash_pred(std::move(r))
+    {
+        ctor_move(std::move(r));
+    }
+
+    hash_map(size_type hint_size, const hasher& hf = hasher(), const key_equal& eql = key_equal()) :
+        hash_pred(hf, eql)
+    {
+        ctor_pow2<this_type>(calc_pow2(hint_size));
+    }
+
+    template<typename Iter>
+    hash_map(Iter first, Iter last, const hasher& hf = hasher(), const key_equal& eql = key_equal()) :
+        hash_pred(hf, eql)
+    {
+        ctor_iters(first, last, *this, typename std::iterator_traits<Iter>::iterator_category());
+    }
+
+#if (__cplusplus >= 201402L || _MSC_VER > 1600 || __clang__)
+    hash_map(std::initializer_list<value_type> lst, const hasher& hf = hasher(), const key_equal& eql = key_equal()) :
+        hash_pred(hf, eql)
+    {
+        ctor_init_list(lst, *this);
+    }
+#endif
+
+    ~hash_map() {
+        hash_base::dtor(IS_TRIVIALLY_DESTRUCTIBLE(), this);
+    }
+
+    static constexpr size_type max_size() noexcept {
+        return (size_type(1) << (sizeof(size_type) * 8 - 1)) / (sizeof(storage_type) + 1);
+    }
+
+    iterator begin() noexcept {
+        return begin_<this_type>();
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_cast<this_type*>(this)->begin();
+    }
+
+    iterator end() noexcept {
+        return iterator();
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator();
+    }
+
+    void reserve(size_type hint) {
+        if (HRD_LIKELY(hint > gap_(_capacity) - _erased))
+            resize_pow2(calc_pow2(hint), *this);
+    }
+
+    void clear() noexcept {
+        hash_base::clear<this_type>(IS_TRIVIALLY_DESTRUCTIBLE());
+    }
+
+    void swap(hash_map& r) noexcept {
+        hash_base::swap(r);
+        hash_pred::swap(r);
+    }
+
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(const value_type& val) {
+        return insert_(val, *this);
+    }
+
+    template <class P>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(P&& val) {
+        return insert_(std::forward<P>(val), *this);
+    }
+
+    template<typename Iter>
+    HRD_ALWAYS_INLINE void insert(Iter first, Iter last) {
+        insert_iters(first, last, *this, typename std::iterator_traits<Iter>::iterator_category());
+    }
+
+#if (__cplusplus >= 201402L || _MSC_VER > 1600 || __clang__)
+    void insert(std::initializer_list<value_type> lst) {
+        insert_iters(lst.begin(), lst.end(), *this, std::random_access_iterator_tag());
+    }
+
+    template<class... Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace(const Key& key, Args&&... args) {
+        return emplace_(key, std::forward<Args>(args)...);
+    }
+
+    template<class K, class... Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
+        return emplace_(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
+    /*! Can invalidate iterators. Probes first: mapped value constructed from args only if k is absent, args untouched otherwise.
+    * \return iterator to the element with key k and true if inserted
+    */
+    template<class... Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+        return emplace_(k, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+        return emplace_(std::move(k), std::forward<Args>(args)...);
+    }
+#else
+    template<class Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace(const Key& key, Args&& args) {
+        return emplace_(key, std::forward<Args>(args));
+    }
+
+    template<class K, class Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace(K&& key, Args&& args) {
+        return emplace_(std::forward<K>(key), std::forward<Args>(args));
+    }
+#endif //C++-11 support
+
+    /*! Can invalidate iterators. obj assigned to mapped value of present k, inserted with k (constructed from obj) otherwise.
+    * \return iterator to the element with key k and true if inserted
+    */
+    template<class M>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+        std::pair<iterator, bool> ret = emplace_(k, std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+
+    template<class M>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+        std::pair<iterator, bool> ret = emplace_(std::move(k), std::forward<M>(obj));
+        if (!ret.second)
+            ret.first->second = std::forward<M>(obj);
+        return ret;
+    }
+
+    /*! Can invalidate iterators.
+    * \params hash - hash of val.first computed before by hasher, the same key looked up in several tables is hashed once
+    */
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(const value_type& val, size_t hash) {
+        return insert_(val, hash, *this);
+    }
+
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> insert(value_type&& val, size_t hash) {
+        return insert_(std::move(val), hash, *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE iterator find(const key_arg<K>& k) noexcept {
+        return find_iter_(k, hash_pred::operator()(k), *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE const_iterator find(const key_arg<K>& k) const noexcept {
+        return find_iter_(k, hash_pred::operator()(k), *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type count(const key_arg<K>& k) const noexcept {
+        return find_(k, hash_pred::operator()(k), *this) != nullptr;
+    }
+
+    //lookups by hash of k computed before, see insert(val, hash)
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE iterator find(const key_arg<K>& k, size_t hash) noexcept {
+        return find_iter_(k, hash, *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE const_iterator find(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_iter_(k, hash, *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type count(const key_arg<K>& k, size_t hash) const noexcept {
+        return find_(k, hash, *this) != nullptr;
+    }
+
+    /*! Doesn't invalidate iterators.
+    * \params it - Iterator pointing to a single element to be removed
+    * \return return an iterator pointing to the position immediately following of the element erased
+    */
+    HRD_ALWAYS_INLINE iterator erase(const_iterator it) noexcept {
+        return erase_<this_type>(it);
+    }
+
+    //exact match for iterator argument, erase(key_arg<K>) of transparent table takes it otherwise
+    HRD_ALWAYS_INLINE iterator erase(iterator it) noexcept {
+        return erase(const_iterator(it));
+    }
+
+    /*! Doesn't invalidate iterators.
+    * \params k - Key of the element to be erased
+    * \return 1 - if element erased and zero otherwise
+    */
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type erase(const key_arg<K>& k) noexcept {
+        return erase_(k, hash_pred::operator()(k), *this);
+    }
+
+    template<class K = key_type>
+    HRD_ALWAYS_INLINE size_type erase(const key_arg<K>& k, size_t hash) noexcept {
+        return erase_(k, hash, *this);
+    }
+
+    HRD_ALWAYS_INLINE void shrink_to_fit() {
+        hash_base::shrink_to_fit<this_type>(*this);
+    }
+
+    HRD_ALWAYS_INLINE hash_map& operator=(const hash_map& r) {
+        this_type(r).swap(*this);
+        return *this;
+    }
+
+    HRD_ALWAYS_INLINE hash_map& operator=(hash_map&& r) noexcept {
+        swap(r);
+        return *this;
+    }
+
+    HRD_ALWAYS_INLINE mapped_type& operator[](const key_type& k) {
+        return find_insert_(k, hash_pred::operator()(k));
+    }
+
+    HRD_ALWAYS_INLINE mapped_type& operator[](key_type&& k) {
+        return find_insert_(std::move(k), hash_pred::operator()(k));
+    }
+
+    //operator[] by hash of k computed before, see insert(val, hash)
+    HRD_ALWAYS_INLINE mapped_type& find_insert(const key_type& k, size_t hash) {
+        return find_insert_(k, hash);
+    }
+
+    HRD_ALWAYS_INLINE mapped_type& find_insert(key_type&& k, size_t hash) {
+        return find_insert_(std::move(k), hash);
+    }
+
+private:
+    hash_map(size_type pow2, bool) {
+        ctor_pow2<this_type>(pow2);
+    }
+
+#if (__cplusplus >= 201402L || _MSC_VER > 1600 || __clang__)
+    template<typename K, typename... Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace_(K&& k, Args&&... args)
+#else
+    template<typename K, typename Args>
+    HRD_ALWAYS_INLINE std::pair<iterator, bool> emplace_(K&& k, Args&& args)
+#endif //C++-11 support
+    {
+        size_t h = hash_pred::operator()(k);
+        std::pair<size_t, bool> p = prepare_insert_(k, h, *this);
+
+        auto* ee = slots_<this_type>();
+        if (p.second) {
+#if (__cplusplus >= 201402L || _MSC_VER > 1600 || __clang__)
+            new ((void*)&ee[p.first].data) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(k)), std::forward_as_tuple(std::forward<Args>(args)...));
+#else
+            new ((void*)&ee[p.first].data) value_type(std::forward<K>(k), std::forward<Args>(args));
+#endif //C++-11 support
+            commit_insert_(p.first, h);
+        }
+        return std::pair<iterator, bool>(iterator(ee + p.first, _elements + p.first), p.second);
+    }
+
+    template<typename V>
+    HRD_ALWAYS_INLINE mapped_type& find_insert_(V&& k, size_t h)
+    {
+        std::pair<size_t, bool> p = prepare_insert_(k, h, *this);
+
+        auto* ee = slots_<this_type>();
+        if (p.second) {
+            new ((void*)&ee[p.first].data) value_type(std::forward<V>(k), mapped_type());
+            commit_insert_(p.first, h);
+        }
+        return ee[p.first].data.second;
+    }
+};
+
+} //namespace hrd_swiss